@@ -0,0 +1,161 @@
+// Math.divide(x, y): long division of |x| by |y|, one bit per step from
+// bit 14 down, R13 = |x| shifted, R14 = |y|, R15 = the remainder, the
+// quotient in RAM[SP], the steps left in RAM[SP+1], the sign in RAM[SP+2].
+// y = 0 and -32768 on either side are left to the VM code.
+@ARG
+A=M+1
+D=M
+@Math.divide$$vm
+D;JEQ
+@SP
+A=M+1
+A=A+1
+M=0
+@Math.divide$ypositive
+D;JGE
+@SP
+A=M+1
+A=A+1
+M=-1
+D=-D
+@Math.divide$$vm
+D;JLT
+(Math.divide$ypositive)
+@R14
+M=D
+@ARG
+A=M
+D=M
+@Math.divide$xpositive
+D;JGE
+@SP
+A=M+1
+A=A+1
+M=!M
+D=-D
+@Math.divide$$vm
+D;JLT
+(Math.divide$xpositive)
+@R13
+M=D
+@SP
+A=M
+M=0
+// |x| < |y|: the quotient is 0
+@R14
+D=D-M
+@Math.divide$end
+D;JLT
+@R15
+M=0
+@15
+D=A
+@SP
+A=M+1
+M=D
+// bit 15 of |x| is 0, so start with bit 14 on top
+@R13
+D=M
+M=D+M
+(Math.divide$loop)
+// r = 2r plus the top bit of what is left of |x|
+@R15
+D=M
+M=D+M
+@R13
+D=M
+M=D+M
+@Math.divide$shifted
+D;JGE
+@R15
+M=M+1
+(Math.divide$shifted)
+@SP
+A=M
+D=M
+M=D+M
+// subtract |y| when r >= |y|; r can reach 2^16 - 3, and when it is
+// negative as a signed word it is at least 2^15 > |y|
+@R15
+D=M
+@Math.divide$large
+D;JLT
+@R14
+D=D-M
+@Math.divide$next
+D;JLT
+@R15
+M=D
+@Math.divide$take
+0;JMP
+(Math.divide$large)
+@R14
+D=M
+@R15
+M=M-D
+(Math.divide$take)
+@SP
+A=M
+M=M+1
+(Math.divide$next)
+@SP
+A=M+1
+MD=M-1
+@Math.divide$loop
+D;JGT
+(Math.divide$end)
+@SP
+A=M+1
+A=A+1
+D=M
+@Math.divide$result
+D;JEQ
+@SP
+A=M
+M=-M
+(Math.divide$result)
+@SP
+A=M
+D=M
+// return D: ARG[0] = D, SP = ARG + 1, restore the caller's frame
+@ARG
+A=M
+M=D
+@ARG
+D=M+1
+@R13
+M=D
+@LCL
+D=M
+@5
+A=D-A
+D=M
+@R14
+M=D
+@LCL
+AM=M-1
+D=M
+@THAT
+M=D
+@LCL
+AM=M-1
+D=M
+@THIS
+M=D
+@LCL
+AM=M-1
+D=M
+@ARG
+M=D
+@LCL
+A=M-1
+D=M
+@LCL
+M=D
+@R13
+D=M
+@SP
+M=D
+@R14
+A=M
+0;JMP
@@ -0,0 +1,115 @@
+// Math.multiply(x, y): shift-add over the bits of y, R13 = x shifted,
+// R14 = the bits of y still to add, R15 = the sum, the bit in RAM[SP]
+@ARG
+A=M
+D=M
+@R13
+M=D
+@ARG
+A=M+1
+D=M
+@R14
+M=D
+// x * y = -x * -y, so y can be made positive (but for -32768)
+@Math.multiply$positive
+D;JGE
+@R14
+M=-M
+@R13
+M=-M
+(Math.multiply$positive)
+// and the smaller of the two when both are positive
+@R13
+D=M
+@Math.multiply$start
+D;JLT
+@R14
+D=D-M
+@Math.multiply$start
+D;JGE
+@R14
+D=M
+@R13
+D=D-M
+M=D+M
+@R14
+M=M-D
+(Math.multiply$start)
+@R15
+M=0
+@SP
+A=M
+M=1
+(Math.multiply$loop)
+@R14
+D=M
+@Math.multiply$done
+D;JEQ
+@SP
+A=M
+D=M
+@R14
+D=D&M
+@Math.multiply$skip
+D;JEQ
+@R14
+M=M-D
+@R13
+D=M
+@R15
+M=D+M
+(Math.multiply$skip)
+@R13
+D=M
+M=D+M
+@SP
+A=M
+D=M
+M=D+M
+@Math.multiply$loop
+0;JMP
+(Math.multiply$done)
+@R15
+D=M
+// return D: ARG[0] = D, SP = ARG + 1, restore the caller's frame
+@ARG
+A=M
+M=D
+@ARG
+D=M+1
+@R13
+M=D
+@LCL
+D=M
+@5
+A=D-A
+D=M
+@R14
+M=D
+@LCL
+AM=M-1
+D=M
+@THAT
+M=D
+@LCL
+AM=M-1
+D=M
+@THIS
+M=D
+@LCL
+AM=M-1
+D=M
+@ARG
+M=D
+@LCL
+A=M-1
+D=M
+@LCL
+M=D
+@R13
+D=M
+@SP
+M=D
+@R14
+A=M
+0;JMP
@@ -0,0 +1,51 @@
+// Memory.poke(address, value): RAM[address] = value
+@ARG
+A=M+1
+D=M
+@ARG
+A=M
+A=M
+M=D
+D=0
+// return D: ARG[0] = D, SP = ARG + 1, restore the caller's frame
+@ARG
+A=M
+M=D
+@ARG
+D=M+1
+@R13
+M=D
+@LCL
+D=M
+@5
+A=D-A
+D=M
+@R14
+M=D
+@LCL
+AM=M-1
+D=M
+@THAT
+M=D
+@LCL
+AM=M-1
+D=M
+@THIS
+M=D
+@LCL
+AM=M-1
+D=M
+@ARG
+M=D
+@LCL
+A=M-1
+D=M
+@LCL
+M=D
+@R13
+D=M
+@SP
+M=D
+@R14
+A=M
+0;JMP
@@ -0,0 +1,176 @@
+// Screen.drawPixel(x, y): the word 16384 + y * 32 + x / 16 in R13, with
+// y * 32 by doublings and x / 16 by bit tests, and the bit twoToThe[x & 15]
+// (Screen.0 = screen, Screen.2 = color, Screen.3 = twoToThe). Before
+// Screen.init has run the VM code does the work.
+@Screen.3
+D=M
+@Screen.drawPixel$$vm
+D;JEQ
+// pixels off the screen are skipped
+@ARG
+A=M+1
+D=M
+@Screen.drawPixel$done
+D;JLT
+@256
+D=D-A
+@Screen.drawPixel$done
+D;JGE
+@ARG
+A=M
+D=M
+@Screen.drawPixel$done
+D;JLT
+@512
+D=D-A
+@Screen.drawPixel$done
+D;JGE
+@ARG
+A=M+1
+D=M
+@R13
+M=D
+D=M
+M=D+M
+D=M
+M=D+M
+D=M
+M=D+M
+D=M
+M=D+M
+D=M
+M=D+M
+@Screen.0
+D=M
+@R13
+M=D+M
+@ARG
+A=M
+D=M
+@R14
+M=D
+@R14
+D=M
+@256
+D=D&A
+@Screen.drawPixel$x256
+D;JEQ
+@16
+D=A
+@R13
+M=D+M
+(Screen.drawPixel$x256)
+@R14
+D=M
+@128
+D=D&A
+@Screen.drawPixel$x128
+D;JEQ
+@8
+D=A
+@R13
+M=D+M
+(Screen.drawPixel$x128)
+@R14
+D=M
+@64
+D=D&A
+@Screen.drawPixel$x64
+D;JEQ
+@4
+D=A
+@R13
+M=D+M
+(Screen.drawPixel$x64)
+@R14
+D=M
+@32
+D=D&A
+@Screen.drawPixel$x32
+D;JEQ
+@2
+D=A
+@R13
+M=D+M
+(Screen.drawPixel$x32)
+@R14
+D=M
+@16
+D=D&A
+@Screen.drawPixel$x16
+D;JEQ
+@1
+D=A
+@R13
+M=D+M
+(Screen.drawPixel$x16)
+@R14
+D=M
+@15
+D=D&A
+@Screen.3
+A=D+M
+D=M
+@R14
+M=D
+@Screen.2
+D=M
+@Screen.drawPixel$erase
+D;JEQ
+@R14
+D=M
+@R13
+A=M
+M=D|M
+@Screen.drawPixel$done
+0;JMP
+(Screen.drawPixel$erase)
+@R14
+D=!M
+@R13
+A=M
+M=D&M
+(Screen.drawPixel$done)
+D=0
+// return D: ARG[0] = D, SP = ARG + 1, restore the caller's frame
+@ARG
+A=M
+M=D
+@ARG
+D=M+1
+@R13
+M=D
+@LCL
+D=M
+@5
+A=D-A
+D=M
+@R14
+M=D
+@LCL
+AM=M-1
+D=M
+@THAT
+M=D
+@LCL
+AM=M-1
+D=M
+@THIS
+M=D
+@LCL
+AM=M-1
+D=M
+@ARG
+M=D
+@LCL
+A=M-1
+D=M
+@LCL
+M=D
+@R13
+D=M
+@SP
+M=D
+@R14
+A=M
+0;JMP
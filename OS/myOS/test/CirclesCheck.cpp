@@ -0,0 +1,82 @@
+// CirclesCheck.cpp
+// draws the circles of OS/myOS/test/Circles row by row, each row reaching
+// the integer square root of r*r - d*d to either side at d rows from the
+// centre, and checks the screen the test left in a RAM dump against them
+
+#include <iostream>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include "../../../assembler/RomImage.h"
+
+namespace {
+
+constexpr size_t SCREEN = 16384;
+constexpr size_t MARKER = 8000;
+constexpr int16_t END_MARKER = 12345;
+
+std::vector<uint16_t> screen(8192);
+
+void pixel(int x, int y, bool black) {
+    if (x < 0 || x > 511 || y < 0 || y > 255) {
+        return;
+    }
+    uint16_t& word = screen[y * 32 + x / 16];
+    uint16_t bit = static_cast<uint16_t>(1u << (x % 16));
+    word = black ? (word | bit) : (word & ~bit);
+}
+
+void circle(int x, int y, int r, bool black) {
+    for (int d = -r; d <= r; ++d) {
+        int h = 0;
+        while ((h + 1) * (h + 1) <= r * r - d * d) {
+            ++h;
+        }
+        for (int i = x - h; i <= x + h; ++i) {
+            pixel(i, y + d, black);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <ram dump>\n"
+                  << "  checks the circles the Circles test left on the screen\n";
+        return 1;
+    }
+    try {
+        std::vector<uint16_t> ram = assembler::readRom(argv[1]);
+        ram.resize(SCREEN + screen.size());
+        if (static_cast<int16_t>(ram[MARKER]) != END_MARKER) {
+            std::cerr << "[Error] the test did not finish\n";
+            return 1;
+        }
+
+        int circles = 3;
+        for (int r = 181; r >= 0; r -= r > 6 ? 7 : 1, ++circles) {
+            circle(256, 128, r, r % 2 == 0);
+        }
+        circle(20, 240, 30, true);
+        circle(500, 5, 40, true);
+        circle(0, 128, 50, false);
+
+        int wrong = 0;
+        for (size_t i = 0; i < screen.size(); ++i) {
+            if (ram[SCREEN + i] != screen[i] && wrong++ == 0) {
+                std::cerr << "first wrong word: row " << i / 32 << ", word " << i % 32 << "\n";
+            }
+        }
+        if (wrong > 0) {
+            std::cerr << "[Error] " << wrong << " screen words differ\n";
+            return 1;
+        }
+        std::cout << circles << " circles drawn like the reference\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+// LinesCheck.cpp
+// draws the lines of OS/myOS/test/Lines pixel by pixel with Bresenham's
+// algorithm, from the left end and stepping down or up, and checks the screen
+// the test left in a RAM dump against them
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "../../../assembler/RomImage.h"
+
+namespace {
+
+constexpr size_t SCREEN = 16384;
+constexpr size_t MARKER = 8000;
+constexpr int16_t END_MARKER = 12345;
+
+// the sequence of Main.next, in 16-bit arithmetic like the Jack code
+int16_t seed = 3;
+
+int next(int m) {
+    seed = static_cast<int16_t>(seed * 5 + 13849);
+    int16_t a = seed < 0 ? static_cast<int16_t>(-seed) : seed;
+    return a % m;
+}
+
+std::vector<uint16_t> screen(8192);
+
+void pixel(int x, int y, bool black) {
+    if (x < 0 || x > 511 || y < 0 || y > 255) {
+        return;
+    }
+    uint16_t& word = screen[y * 32 + x / 16];
+    uint16_t bit = static_cast<uint16_t>(1u << (x % 16));
+    word = black ? (word | bit) : (word & ~bit);
+}
+
+void line(int x1, int y1, int x2, int y2, bool black) {
+    if (x1 > x2) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+    int dx = x2 - x1, dy = std::abs(y2 - y1), step = y2 < y1 ? -1 : 1;
+    int x = x1, y = y1;
+    if (dx > dy) {
+        for (int d = 2 * dy - dx, i = 0; i <= dx; ++i, ++x, d += 2 * dy) {
+            pixel(x, y, black);
+            if (d > 0) {
+                y += step;
+                d -= 2 * dx;
+            }
+        }
+    } else {
+        for (int d = 2 * dx - dy, i = 0; i <= dy; ++i, y += step, d += 2 * dx) {
+            pixel(x, y, black);
+            if (d > 0) {
+                ++x;
+                d -= 2 * dy;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <ram dump>\n"
+                  << "  checks the lines the Lines test left on the screen\n";
+        return 1;
+    }
+    try {
+        std::vector<uint16_t> ram = assembler::readRom(argv[1]);
+        ram.resize(SCREEN + screen.size());
+        if (static_cast<int16_t>(ram[MARKER]) != END_MARKER) {
+            std::cerr << "[Error] the test did not finish\n";
+            return 1;
+        }
+
+        for (int i = 0; i < 400; ++i) {
+            bool black = next(4) > 0;
+            int x1, y1, x2, y2;
+            if (i < 300) {
+                x1 = next(512);
+                y1 = next(256);
+                x2 = next(512);
+                y2 = next(256);
+            } else {
+                x1 = next(700) - 100;
+                y1 = next(400) - 70;
+                x2 = next(700) - 100;
+                y2 = next(400) - 70;
+            }
+            if (next(5) == 0) {
+                y2 = y1;
+            }
+            if (next(5) == 0) {
+                x2 = x1;
+            }
+            line(x1, y1, x2, y2, black);
+        }
+
+        int wrong = 0;
+        for (size_t i = 0; i < screen.size(); ++i) {
+            if (ram[SCREEN + i] != screen[i] && wrong++ == 0) {
+                std::cerr << "first wrong word: row " << i / 32 << ", word " << i % 32 << "\n";
+            }
+        }
+        if (wrong > 0) {
+            std::cerr << "[Error] " << wrong << " screen words differ\n";
+            return 1;
+        }
+        std::cout << "400 lines drawn like the reference\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
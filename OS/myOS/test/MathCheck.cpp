@@ -0,0 +1,75 @@
+// MathCheck.cpp
+// checks the products and quotients OS/myOS/test/Math leaves in the screen
+// memory against 16-bit two's complement arithmetic: products wrap around,
+// quotients truncate toward zero (and -32768 / -1 wraps to -32768)
+
+#include <iostream>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "../../../assembler/RomImage.h"
+
+namespace {
+
+constexpr size_t RESULTS = 16384;
+constexpr size_t SCREEN_END = 24576;
+constexpr int16_t END_MARKER = 12345;
+
+int16_t product(int16_t x, int16_t y) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<int32_t>(x) * y));
+}
+
+int16_t quotient(int16_t x, int16_t y) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<int32_t>(x) / y));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <pairs> <ram dump>\n"
+                  << "  checks that the Math test left the given number of pairs in the dump\n";
+        return 1;
+    }
+    try {
+        std::vector<uint16_t> ram = assembler::readRom(argv[2]);
+        auto word = [&ram](size_t address) {
+            return static_cast<int16_t>(address < ram.size() ? ram[address] : 0);
+        };
+
+        long pairs = word(RESULTS);
+        if (pairs != std::stol(argv[1]) || RESULTS + 1 + 4 * pairs >= SCREEN_END) {
+            std::cerr << "[Error] the test left " << pairs << " pairs, not " << argv[1] << "\n";
+            return 1;
+        }
+        if (word(RESULTS + 1 + 4 * pairs) != END_MARKER) {
+            std::cerr << "[Error] no end marker after the last pair\n";
+            return 1;
+        }
+
+        int failures = 0;
+        for (long i = 0; i < pairs; ++i) {
+            size_t base = RESULTS + 1 + 4 * i;
+            int16_t x = word(base), y = word(base + 1);
+            if (word(base + 2) != product(x, y)) {
+                std::cerr << x << " * " << y << " = " << word(base + 2) << ", not " << product(x, y) << "\n";
+                ++failures;
+            }
+            if (y != 0 && word(base + 3) != quotient(x, y)) {
+                std::cerr << x << " / " << y << " = " << word(base + 3) << ", not " << quotient(x, y) << "\n";
+                ++failures;
+            }
+        }
+        if (failures > 0) {
+            std::cerr << "[Error] " << failures << " wrong results in " << pairs << " pairs\n";
+            return 1;
+        }
+        std::cout << pairs << " pairs multiplied and divided correctly\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// RectanglesCheck.cpp
+// draws the rectangles of OS/myOS/test/Rectangles pixel by pixel and checks
+// the screen the test left in a RAM dump against them
+
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include "../../../assembler/RomImage.h"
+
+namespace {
+
+constexpr size_t SCREEN = 16384;
+constexpr size_t MARKER = 8000;
+constexpr int16_t END_MARKER = 12345;
+
+// the sequence of Main.next, in 16-bit arithmetic like the Jack code
+int16_t seed = 7;
+
+int next(int m) {
+    seed = static_cast<int16_t>(seed * 5 + 13849);
+    int16_t a = seed < 0 ? static_cast<int16_t>(-seed) : seed;
+    return a % m;
+}
+
+std::vector<uint16_t> screen(8192);
+
+void pixel(int x, int y, bool black) {
+    if (x < 0 || x > 511 || y < 0 || y > 255) {
+        return;
+    }
+    uint16_t& word = screen[y * 32 + x / 16];
+    uint16_t bit = static_cast<uint16_t>(1u << (x % 16));
+    word = black ? (word | bit) : (word & ~bit);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <ram dump>\n"
+                  << "  checks the rectangles the Rectangles test left on the screen\n";
+        return 1;
+    }
+    try {
+        std::vector<uint16_t> ram = assembler::readRom(argv[1]);
+        ram.resize(SCREEN + screen.size());
+        if (static_cast<int16_t>(ram[MARKER]) != END_MARKER) {
+            std::cerr << "[Error] the test did not finish\n";
+            return 1;
+        }
+
+        for (int i = 0; i < 200; ++i) {
+            if (i == 100) {
+                std::fill(screen.begin(), screen.end(), 0);
+            }
+            bool black = next(3) > 0;
+            int x1 = next(600) - 40;
+            int y1 = next(320) - 30;
+            int x2 = x1 + next(200) - 10;
+            int y2 = y1 + next(100) - 5;
+            if (next(6) == 0) {
+                x2 = x1;
+            }
+            if (next(6) == 0) {
+                y2 = y1;
+            }
+            for (int y = y1; y <= y2; ++y) {
+                for (int x = x1; x <= x2; ++x) {
+                    pixel(x, y, black);
+                }
+            }
+        }
+
+        int wrong = 0;
+        for (size_t i = 0; i < screen.size(); ++i) {
+            if (ram[SCREEN + i] != screen[i] && wrong++ == 0) {
+                std::cerr << "first wrong word: row " << i / 32 << ", word " << i % 32 << "\n";
+            }
+        }
+        if (wrong > 0) {
+            std::cerr << "[Error] " << wrong << " screen words differ\n";
+            return 1;
+        }
+        std::cout << "200 rectangles drawn like the reference\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// StringCheck.cpp
+// checks what OS/myOS/test/String leaves in the screen memory: every value
+// survived setInt and intValue, the edge strings parse as expected, and
+// setInt writes the same digits as C++ for every sampled value
+
+#include <iostream>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "../../../assembler/RomImage.h"
+
+namespace {
+
+constexpr size_t RESULTS = 16384;
+constexpr size_t SCREEN_END = 24576;
+constexpr int16_t END_MARKER = 12345;
+
+struct Parse {
+    const char* text;
+    int16_t value;
+};
+
+// in the order the test parses them, from RAM[16387] on
+constexpr Parse parses[] = {
+    {"-0", 0}, {"0", 0}, {"-32768", -32768}, {"32767", 32767},
+    {"12abc", 12}, {"-", 0}, {"", 0}, {"007", 7}
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <ram dump>\n"
+                  << "  checks the results the String test left in the dump\n";
+        return 1;
+    }
+    try {
+        std::vector<uint16_t> ram = assembler::readRom(argv[1]);
+        auto word = [&ram](size_t address) {
+            return static_cast<int16_t>(address < ram.size() ? ram[address] : 0);
+        };
+        int failures = 0;
+
+        if (word(RESULTS + 2) != 32767) {
+            std::cerr << "round trip stopped after " << word(RESULTS + 2) << "\n";
+            ++failures;
+        }
+        if (word(RESULTS) != 0) {
+            std::cerr << word(RESULTS) << " values failed the round trip, the first "
+                      << word(RESULTS + 1) << "\n";
+            ++failures;
+        }
+        for (size_t i = 0; i < std::size(parses); ++i) {
+            if (word(RESULTS + 3 + i) != parses[i].value) {
+                std::cerr << "\"" << parses[i].text << "\".intValue() = " << word(RESULTS + 3 + i)
+                          << ", not " << parses[i].value << "\n";
+                ++failures;
+            }
+        }
+
+        long samples = word(RESULTS + 16);
+        size_t at = RESULTS + 17;
+        if (samples <= 0 || at + 8 * samples >= SCREEN_END || word(at + 8 * samples) != END_MARKER) {
+            std::cerr << "[Error] no end marker after " << samples << " samples\n";
+            return 1;
+        }
+        for (long i = 0; i < samples; ++i, at += 8) {
+            std::string want = std::to_string(word(at));
+            std::string got;
+            for (int16_t j = 0; j < word(at + 1) && j < 6; ++j) {
+                got += static_cast<char>(word(at + 2 + j));
+            }
+            if (got != want || word(at + 1) > 6) {
+                std::cerr << "setInt(" << word(at) << ") wrote \"" << got << "\"\n";
+                ++failures;
+            }
+        }
+
+        if (failures > 0) {
+            std::cerr << "[Error] " << failures << " failures\n";
+            return 1;
+        }
+        std::cout << "65536 values round-tripped, " << std::size(parses) << " strings parsed and "
+                  << samples << " formatted like C++\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+// TextCheck.cpp
+// prints what OS/myOS/test/Text prints, pixel by pixel from the font table in
+// tools/gen_font.py that Output's glyphs are generated from, and checks the
+// screen the test left in a RAM dump against it
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../../assembler/RomImage.h"
+
+namespace {
+
+constexpr size_t SCREEN = 16384;
+constexpr size_t MARKER = 8000;
+constexpr int16_t END_MARKER = 12345;
+constexpr int NEW_LINE = 128;
+constexpr int BACK_SPACE = 129;
+
+using Glyph = std::array<int, 11>;
+
+// the "(char, [row, ...])," lines of the FONT table
+std::map<int, Glyph> readFont(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("[Error] cannot open " + path);
+    }
+    std::map<int, Glyph> font;
+    std::string line;
+    while (std::getline(in, line)) {
+        int c;
+        Glyph g;
+        if (std::sscanf(line.c_str(), " (%d, [%d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d])", &c,
+                        &g[0], &g[1], &g[2], &g[3], &g[4], &g[5], &g[6], &g[7], &g[8], &g[9],
+                        &g[10]) == 12) {
+            font[c] = g;
+        }
+    }
+    if (font.size() != 96 || font.count(0) == 0) {
+        throw std::runtime_error("[Error] no font table of 96 glyphs in " + path);
+    }
+    return font;
+}
+
+std::vector<uint16_t> screen(8192);
+
+void pixel(int x, int y, bool black) {
+    uint16_t& word = screen[y * 32 + x / 16];
+    uint16_t bit = static_cast<uint16_t>(1u << (x % 16));
+    word = black ? (word | bit) : (word & ~bit);
+}
+
+// the text cursor of Output, drawing into screen
+struct Cursor {
+    const std::map<int, Glyph>& font;
+    int cx = 0, cy = 0;
+
+    // the glyph's 6 pixel columns sit one pixel into the 8 pixel cell
+    void draw(int c) {
+        const Glyph& g = font.at(c >= 32 && c <= 126 ? c : 0);
+        for (int row = 0; row < 11; ++row) {
+            for (int b = 0; b < 8; ++b) {
+                pixel(cx * 8 + b, cy * 11 + row, b >= 1 && b <= 6 && ((g[row] >> (b - 1)) & 1));
+            }
+        }
+    }
+
+    void print(int c) {
+        if (c == NEW_LINE) {
+            cx = 0;
+            cy = std::min(cy + 1, 22);
+        } else if (c == BACK_SPACE) {
+            if (cx == 0 && cy == 0) {
+                return;
+            }
+            if (cx > 0) {
+                --cx;
+            } else {
+                --cy;
+                cx = 63;
+            }
+            draw(' ');
+        } else {
+            draw(c);
+            if (cx < 63) {
+                ++cx;
+            } else {
+                cx = 0;
+                cy = std::min(cy + 1, 22);
+            }
+        }
+    }
+
+    void move(int i, int j) {
+        cy = i;
+        cx = j;
+        draw(' ');
+    }
+};
+
+void rectangle(int x1, int y1, int x2, int y2) {
+    for (int y = y1; y <= y2; ++y) {
+        for (int x = x1; x <= x2; ++x) {
+            pixel(x, y, true);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <gen_font.py> <ram dump>\n"
+                  << "  checks the text the Text test left on the screen\n";
+        return 1;
+    }
+    try {
+        Cursor cursor{readFont(argv[1])};
+        std::vector<uint16_t> ram = assembler::readRom(argv[2]);
+        ram.resize(SCREEN + screen.size());
+        if (static_cast<int16_t>(ram[MARKER]) != END_MARKER) {
+            std::cerr << "[Error] the test did not finish\n";
+            return 1;
+        }
+
+        rectangle(0, 0, 511, 255);
+        for (int i = 0; i < 200; ++i) {
+            cursor.print(32 + i % 97);
+        }
+        for (int c : {NEW_LINE, 65, BACK_SPACE, BACK_SPACE}) {
+            cursor.print(c);
+        }
+        cursor.move(10, 63);
+        cursor.print(66);
+        cursor.print(67);
+        cursor.move(22, 62);
+        for (int c : {3, 68, 69, 70}) {
+            cursor.print(c);
+        }
+        rectangle(500, 250, 511, 255);
+
+        int wrong = 0;
+        for (size_t i = 0; i < screen.size(); ++i) {
+            if (ram[SCREEN + i] != screen[i] && wrong++ == 0) {
+                std::cerr << "first wrong word: row " << i / 32 << ", word " << i % 32 << "\n";
+            }
+        }
+        if (wrong > 0) {
+            std::cerr << "[Error] " << wrong << " screen words differ\n";
+            return 1;
+        }
+        std::cout << "text printed like the reference, on top of the drawing\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Profiles the myOS benchmarks in OS/myOS/test/bench and prints the
+# instructions per call of the functions each one lists in its bench.txt.
+# A line "A - B" leaves out the instructions of the calls A makes to B.
+
+usage() {
+    cat <<EOF
+Usage: $0 [--native] [--rev <git rev>]... [BENCHMARK...]
+Options:
+  --native        also build with the native bodies in OS/myOS/native
+  --rev <rev>     also build with OS/myOS as it was at that git revision
+  -h|--help       show this help
+Runs every benchmark in OS/myOS/test/bench if none is given. The tools are
+taken from HACKC and EMULATOR (default: ./hackc and ./emulator/Emulator).
+EOF
+}
+
+REPO="$(cd "$(dirname "$0")/../../.." && pwd)"
+HACKC="${HACKC:-$REPO/hackc}"
+EMULATOR="${EMULATOR:-$REPO/emulator/Emulator}"
+BENCH_DIR="$REPO/OS/myOS/test/bench"
+
+variants=(myOS)
+benchmarks=()
+while (( $# )); do
+    case "$1" in
+        --native) variants+=(native); shift ;;
+        --rev)
+            [[ $# -ge 2 ]] || { usage >&2; exit 2; }
+            variants+=("$2"); shift 2 ;;
+        -h|--help) usage; exit 0 ;;
+        -*) usage >&2; exit 2 ;;
+        *) benchmarks+=("$1"); shift ;;
+    esac
+done
+if (( ${#benchmarks[@]} == 0 )); then
+    for dir in "$BENCH_DIR"/*/; do
+        benchmarks+=("$(basename "$dir")")
+    done
+fi
+
+for tool in "$HACKC" "$EMULATOR"; do
+    [[ -x "$tool" ]] || { echo "[Error] $tool not found, build it first (see README)" >&2; exit 1; }
+done
+
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+# the OS directory and hackc options of a variant
+variant_args() {
+    case "$1" in
+        myOS) echo "--os $REPO/OS/myOS" ;;
+        native) echo "--os $REPO/OS/myOS --native $REPO/OS/myOS/native" ;;
+        *)
+            local dir="$WORK/rev/$1"
+            if [[ ! -d "$dir" ]]; then
+                mkdir -p "$dir"
+                git -C "$REPO" archive "$1" OS/myOS | tar -x -C "$dir"
+            fi
+            echo "--os $dir/OS/myOS" ;;
+    esac
+}
+
+for bench in "${benchmarks[@]}"; do
+    [[ -f "$BENCH_DIR/$bench/bench.txt" ]] || { echo "[Error] no benchmark $bench" >&2; exit 1; }
+    cycles="$(awk '$1 == "cycles" { print $2 }' "$BENCH_DIR/$bench/bench.txt")"
+
+    # profile every variant: the call counts from the report, the
+    # instructions from the folded stacks
+    for variant in "${variants[@]}"; do
+        out="$WORK/$bench/$variant"
+        mkdir -p "$out"
+        # shellcheck disable=SC2046
+        (cd "$REPO" && "$HACKC" "$BENCH_DIR/$bench" -o "$out/o.hack" --incremental -O -g \
+            $(variant_args "$variant")) > "$out/hackc.log"
+        "$EMULATOR" "$out/o.hack" --max-cycles "$cycles" --profile "$out/o.sym" \
+            --folded "$out/folded" > "$out/profile.log"
+    done
+
+    echo "$bench: instructions per call"
+    printf '  %-36s' function
+    printf ' %12s' "${variants[@]}"
+    echo
+    awk '$1 != "cycles"' "$BENCH_DIR/$bench/bench.txt" | while read -r name minus other; do
+        label="$name${minus:+ - $other}"
+        printf '  %-36s' "$label"
+        for variant in "${variants[@]}"; do
+            awk -v f="$name" -v g="${other:-}" '
+                FILENAME ~ /profile.log$/ { if ($NF == f) calls = $(NF - 1); next }
+                {
+                    n = split($1, stack, ";")
+                    for (i = 1; i <= n && stack[i] != f; ++i) {}
+                    for (j = i + 1; j <= n && stack[j] != g; ++j) {}
+                    if (i <= n && j > n) instructions += $2
+                }
+                END { if (calls > 0) printf " %12d", instructions / calls; else printf " %12s", "-" }
+            ' "$WORK/$bench/$variant/profile.log" "$WORK/$bench/$variant/folded"
+        done
+        echo
+    done
+done
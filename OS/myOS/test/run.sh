@@ -0,0 +1,85 @@
+#!/usr/bin/env bash
+# myOS checks: the committed .vm files are compiled from the .jack sources,
+# the glyphs in Output.jack are generated from tools/gen_font.py, and each
+# test program under OS/myOS/test leaves the values in its expected.txt (or
+# ones its checker accepts) in the screen memory, with and without the
+# native bodies
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$REPO"
+
+mkdir -p "$WORK/os"
+cp OS/myOS/*.jack "$WORK/os/"
+"$BIN/j" "$WORK/os" > /dev/null
+for vm in "$WORK/os"/*.vm; do
+    cmp -s "$vm" "OS/myOS/$(basename "$vm")" || fail "OS/myOS/$(basename "$vm") is out of date with its .jack"
+done
+ok "OS/myOS .vm files are up to date"
+
+# the packed glyphs in Output.jack are what tools/gen_font.py makes of its table
+if command -v python3 > /dev/null; then
+    python3 tools/gen_font.py "$WORK/os/Output.jack"
+    same "Output.jack glyphs are generated from tools/gen_font.py" OS/myOS/Output.jack "$WORK/os/Output.jack"
+else
+    ok "no python3, Output.jack glyphs not checked"
+fi
+
+# check <program> <cycles> [checker...]: builds OS/myOS/test/<program> on
+# myOS, with and without --native, runs it and compares its results with its
+# expected.txt, or runs the checker on a .bin dump of its RAM
+check() {
+    local program="$1" cycles="$2"
+    shift 2
+    for native in "" --native; do
+        local out="$WORK/$program$native" what="$program ${native:-(translated)}"
+        hackc "OS/myOS/test/$program" -o "$out/o.hack" --os OS/myOS --incremental -O \
+            ${native:+--native OS/myOS/native}
+        if (( $# )); then
+            run "$out/o.hack" "$cycles" "$out/ram.bin"
+            "$@" "$out/ram.bin" > "$out/check.log" 2>&1 || { cat "$out/check.log" >&2; fail "$what"; }
+            ok "$what: $(tail -1 "$out/check.log")"
+        else
+            local expected="OS/myOS/test/$program/expected.txt"
+            run "$out/o.hack" "$cycles" "$out/ram.hack"
+            ram "$out/ram.hack" 16384 "$(wc -l < "$expected")" > "$out/results.txt"
+            same "$what" "$expected" "$out/results.txt"
+        fi
+    done
+}
+
+for checker in MathCheck StringCheck RectanglesCheck LinesCheck TextCheck CirclesCheck; do
+    "${CXX:-g++}" -std=c++17 -O2 -o "$WORK/$checker" "OS/myOS/test/$checker.cpp" assembler/RomImage.cpp
+done
+
+check Memory 20000000
+check Math 30000000 "$WORK/MathCheck" 1744
+check String 500000000 "$WORK/StringCheck"
+check Rectangles 20000000 "$WORK/RectanglesCheck"
+check Lines 80000000 "$WORK/LinesCheck"
+check Text 10000000 "$WORK/TextCheck" tools/gen_font.py
+check Circles 30000000 "$WORK/CirclesCheck"
+
+# the benchmarks still run in about the instructions per call they took
+# when they were written (see bench.sh); a bound is twice that
+# bound <benchmark> <function line> <most instructions per call> [--native]:
+# checks the last column bench.sh prints, the native one with --native
+bound() {
+    local log="$WORK/bench-$1${4:-}.log" per_call
+    if [[ ! -f "$log" ]]; then
+        HACKC="$BIN/hackc" EMULATOR="$BIN/Emulator" OS/myOS/test/bench.sh ${4:-} "$1" > "$log" ||
+            { cat "$log" >&2; fail "bench.sh $1"; }
+    fi
+    per_call="$(awk -v f="$2" 'substr($0, 3, length(f)) == f { print $NF }' "$log")"
+    [[ "$per_call" =~ ^[0-9]+$ ]] || fail "bench.sh $1 did not report $2"
+    (( per_call <= $3 )) || fail "$1: $2 takes $per_call instructions per call, more than $3"
+    ok "$1: $2 takes $per_call instructions per call${4:+ ($4)}"
+}
+
+bound PrintInt "Output.printInt - Output.printChar" 13000
+bound PrintInt "String.setInt" 9000
+bound Native "Math.multiply" 800 --native
+bound Native "Math.divide" 600 --native
+bound Native "Screen.drawPixel - Screen.init" 300 --native
+bound Native "Memory.peek" 90 --native
+bound Native "Memory.poke" 100 --native
+bound Startup "Sys.init - Main.main" 3600
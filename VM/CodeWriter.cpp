@@ -0,0 +1,351 @@
+#include "CodeWriter.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace vm {
+
+CodeWriter::CodeWriter(const std::string &asm_file_path) : out(asm_file) {
+    asm_file.open(asm_file_path);
+    if (!asm_file.is_open()) {
+        throw std::runtime_error("[Error] unable to create output asm file");
+    }
+}
+
+CodeWriter::CodeWriter(std::ostream &stream) : out(stream) {}
+
+CodeWriter::~CodeWriter() {
+    if (asm_file.is_open())
+        asm_file.close();
+}
+
+void CodeWriter::push(const std::string &segment, int index) {
+    static const std::unordered_map<std::string, std::string> base {
+        {"local", "LCL"}, {"argument", "ARG"}, {"this", "THIS"}, {"that", "THAT"}
+    };
+
+    if (segment == "constant") {
+        out << "@" << index << "\n"
+            << "D=A\n";
+    } else if (segment == "temp") {
+        out << "@" << 5 + index << "\n"
+            << "D=M\n";
+    } else if (segment == "pointer") {
+        out << "@" << 3 + index << "\n"
+            << "D=M\n";
+    } else if (segment == "static") {
+        out << "@" << file_name_base << "." << index << "\n"
+            << "D=M\n";
+    } else {
+        out << "@" << base.at(segment) << "\n"
+            << "D=M\n"
+            << "@" << index << "\n"
+            << "A=D+A\n"
+            << "D=M\n";
+    }
+
+    out << "@SP\n"
+        << "A=M\n"
+        << "M=D\n"
+        << "@SP\n"
+        << "M=M+1\n";
+}
+
+void CodeWriter::pop(const std::string &segment, int index) {
+    static const std::unordered_map<std::string, std::string> base {
+        {"local", "LCL"}, {"argument", "ARG"}, {"this", "THIS"}, {"that", "THAT"}
+    };
+
+    if (segment == "temp" || segment == "pointer" || segment == "static") {
+        std::string symbol = (segment == "temp")    ? std::to_string(5 + index) :
+                             (segment == "pointer") ? std::to_string(3 + index) :
+                                                       (file_name_base + "." + std::to_string(index));
+        out << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "@" << symbol << "\n"
+            << "M=D\n";
+    } else {
+        out << "@" << base.at(segment) << "\n"
+            << "D=M\n"
+            << "@" << index << "\n"
+            << "D=D+A\n"
+            << "@R13\n"
+            << "M=D\n"
+            << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "@R13\n"
+            << "A=M\n"
+            << "M=D\n";
+    }
+}
+
+void CodeWriter::setFileName(const std::string& vm_filepath) {
+    namespace fs = std::filesystem;
+    fs::path p(vm_filepath);
+    this->file_name_base = p.stem().string();
+    source_name = p.filename().string();
+    last_line = 0;
+}
+
+void CodeWriter::writeInit() {
+    out << "// Bootstrap Code\n"
+        << "@256\n"
+        << "D=A\n"
+        << "@SP\n"
+        << "M=D\n";
+    writeCall("Sys.init", 0);
+}
+
+void CodeWriter::writeArithmetic(const std::string &cmd) {
+    if (cmd == "add") {
+        out << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "A=A-1\n"
+            << "M=D+M\n";
+    } else if (cmd == "sub") {
+        out << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "A=A-1\n"
+            << "M=M-D\n";
+    } else if (cmd == "neg") {
+        out << "@SP\n"
+            << "A=M-1\n"
+            << "M=-M\n";
+    } else if (cmd == "and") {
+        out << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "A=A-1\n"
+            << "M=D&M\n";
+    } else if (cmd == "or") {
+        out << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "A=A-1\n"
+            << "M=D|M\n";
+    } else if (cmd == "not") {
+        out << "@SP\n"
+            << "A=M-1\n"
+            << "M=!M\n";
+    } else if (cmd == "eq" || cmd == "gt" || cmd == "lt") {
+        std::string jmp = (cmd == "eq") ? "JEQ" : (cmd == "gt" ? "JGT" : "JLT");
+        std::string label_true = "BOOL_TRUE_" + std::to_string(label_counter);
+        std::string label_end  = "BOOL_END_"  + std::to_string(label_counter);
+        label_counter++;
+
+        out << "@SP\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "A=A-1\n"
+            << "D=M-D\n"
+            << "@" << label_true << "\n"
+            << "D;" << jmp << "\n"
+            << "@SP\n"
+            << "A=M-1\n"
+            << "M=0\n" // false
+            << "@" << label_end << "\n"
+            << "0;JMP\n"
+            << "(" << label_true << ")\n"
+            << "@SP\n"
+            << "A=M-1\n"
+            << "M=-1\n" // true
+            << "(" << label_end << ")\n";
+    }
+}
+
+void CodeWriter::writePushPop(CommandType type, const std::string &seg, int idx) {
+    out << "// " << (type == CommandType::C_PUSH ? "push" : "pop") << " " << seg << " " << idx << "\n";
+    if (type == CommandType::C_PUSH) {
+        push(seg, idx);
+    } else if (type == CommandType::C_POP) {
+        pop(seg, idx);
+    }
+}
+
+void CodeWriter::writeLabel(const std::string &label) {
+    out << "(" << current_function_name << "$" << label << ")\n";
+}
+
+void CodeWriter::writeGoto(const std::string &label) {
+    out << "@" << current_function_name << "$" << label << "\n"
+        << "0;JMP\n";
+}
+
+void CodeWriter::writeIf(const std::string &label) {
+    out << "@SP\n"
+        << "AM=M-1\n"
+        << "D=M\n"
+        << "@" << current_function_name << "$" << label << "\n"
+        << "D;JNE\n";
+}
+
+void CodeWriter::writeFunction(const std::string &name, int nLocals) {
+    current_function_name = name;
+    out << "(" << name << ")\n";
+    if (const std::string* body = natives ? natives->find(name) : nullptr) {
+        // the hand-written body takes the entry, the translation goes behind it
+        out << "// native " << name << "\n"
+            << *body
+            << "(" << name << "$$vm)\n";
+    }
+    for (int i = 0; i < nLocals; ++i) {
+        push("constant", 0);
+    }
+}
+
+void CodeWriter::writeCall(const std::string &name, int nArgs) {
+    std::string ret_label = name + "$ret." + std::to_string(label_counter++);
+    out << "// call " << name << " " << nArgs << "\n";
+
+    // VM$call builds the frame: R13 = nArgs, R14 = function, D = return address
+    out << "@" << nArgs << "\n"
+        << "D=A\n"
+        << "@R13\n"
+        << "M=D\n"
+        << "@" << name << "\n"
+        << "D=A\n"
+        << "@R14\n"
+        << "M=D\n"
+        << "@" << ret_label << "\n"
+        << "D=A\n"
+        << "@VM$call\n"
+        << "0;JMP\n"
+        << "(" << ret_label << ")\n";
+    uses_runtime = true;
+}
+
+void CodeWriter::writeReturn() {
+    out << "// return\n"
+        << "@VM$return\n"
+        << "0;JMP\n";
+    uses_runtime = true;
+}
+
+void CodeWriter::writeRuntime() {
+    out << "// call: D = return address, R13 = nArgs, R14 = function\n"
+        << "(VM$call)\n";
+
+    // push return-address, LCL, ARG, THIS, THAT
+    out << "@SP\n"
+        << "A=M\n"
+        << "M=D\n";
+    for (const char* seg : {"LCL", "ARG", "THIS", "THAT"}) {
+        out << "@" << seg << "\n"
+            << "D=M\n"
+            << "@SP\n"
+            << "AM=M+1\n"
+            << "M=D\n";
+    }
+
+    // LCL = SP
+    out << "@SP\n"
+        << "MD=M+1\n"
+        << "@LCL\n"
+        << "M=D\n";
+
+    // ARG = SP - nArgs - 5
+    out << "@R13\n"
+        << "D=D-M\n"
+        << "@5\n"
+        << "D=D-A\n"
+        << "@ARG\n"
+        << "M=D\n";
+
+    // goto function
+    out << "@R14\n"
+        << "A=M\n"
+        << "0;JMP\n";
+
+    out << "// return\n"
+        << "(VM$return)\n";
+
+    // FRAME = LCL (R13)
+    out << "@LCL\n"
+        << "D=M\n"
+        << "@R13\n"
+        << "M=D\n";
+
+    // RET = *(FRAME-5) (R14)
+    out << "@5\n"
+        << "A=D-A\n"
+        << "D=M\n"
+        << "@R14\n"
+        << "M=D\n";
+
+    // *ARG = pop()
+    out << "@SP\n"
+        << "AM=M-1\n"
+        << "D=M\n"
+        << "@ARG\n"
+        << "A=M\n"
+        << "M=D\n";
+
+    // SP = ARG+1
+    out << "@ARG\n"
+        << "D=M+1\n"
+        << "@SP\n"
+        << "M=D\n";
+
+    // Restore THAT, THIS, ARG, LCL
+    for (const char* seg : {"THAT", "THIS", "ARG", "LCL"}) {
+        out << "@R13\n"
+            << "AM=M-1\n"
+            << "D=M\n"
+            << "@" << seg << "\n"
+            << "M=D\n";
+    }
+
+    // goto RET
+    out << "@R14\n"
+        << "A=M\n"
+        << "0;JMP\n";
+}
+
+void CodeWriter::close() {
+    if (asm_file.is_open())
+        asm_file.close();
+    else
+        out.flush();
+}
+
+void CodeWriter::write(const Command &cmd) {
+    if (source_lines && cmd.line != 0 && cmd.line != last_line) {
+        out << "// " << source_name << ":" << cmd.line << "\n";
+        last_line = cmd.line;
+    }
+    switch (cmd.type) {
+        case CommandType::C_ARITHMETIC: writeArithmetic(cmd.arg1); break;
+        case CommandType::C_PUSH:
+        case CommandType::C_POP:        writePushPop(cmd.type, cmd.arg1, cmd.arg2); break;
+        case CommandType::C_LABEL:      writeLabel(cmd.arg1); break;
+        case CommandType::C_GOTO:       writeGoto(cmd.arg1); break;
+        case CommandType::C_IF:         writeIf(cmd.arg1); break;
+        case CommandType::C_FUNCTION:   writeFunction(cmd.arg1, cmd.arg2); break;
+        case CommandType::C_CALL:       writeCall(cmd.arg1, cmd.arg2); break;
+        case CommandType::C_RETURN:     writeReturn(); break;
+    }
+}
+
+void CodeWriter::writeModule(const Module &module) {
+    file_name_base = module.name;
+    source_name = module.source.empty() ? module.name + ".vm" : module.source;
+    last_line = 0;
+    for (const Command &cmd : module.commands) {
+        write(cmd);
+    }
+}
+
+void CodeWriter::code(Parser &parser) {
+    while (parser.hasMoreCommands()) {
+        parser.advance();
+        if (parser.current_command.empty()) continue;
+        write(parser.command());
+    }
+}
+
+} // namespace vm
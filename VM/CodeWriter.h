@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <ostream>
+
+#include "VMCommand.h"
+#include "Parser.h"
+#include "NativeBodies.h"
+
+namespace vm {
+
+// translates VM commands to Hack assembly, into a .asm file or any output stream
+class CodeWriter {
+    std::string file_name_base; // Stores base name like "Sys" for static variables
+    std::string current_function_name; // Stores current function for labels
+    std::ofstream asm_file; // only used when constructed from a path
+    std::ostream& out;
+    unsigned int label_counter = 0;
+    bool source_lines = false;
+    std::string source_name;    // file named in source line comments
+    unsigned int last_line = 0;
+    const NativeBodies* natives = nullptr;
+    bool uses_runtime = false;  // a call or return jumps to the shared routines
+
+    void push(const std::string &segment, int index);
+    void pop(const std::string &segment, int index);
+
+public:
+    explicit CodeWriter(const std::string &asm_file_path);
+    explicit CodeWriter(std::ostream &stream);
+    ~CodeWriter();
+
+    void setFileName(const std::string& vm_filepath);
+
+    // precedes the code of each command that starts a new source line with a
+    // "// File.vm:line" comment, which the assembler turns into a source map
+    void setSourceLines(bool enabled) { source_lines = enabled; }
+
+    // functions with a hand-written body get it at their entry, see
+    // NativeBodies; bodies must outlive the writer
+    void setNativeBodies(const NativeBodies* bodies) { natives = bodies; }
+
+    void writeInit();
+    void writeArithmetic(const std::string &cmd);
+    void writePushPop(CommandType type, const std::string &seg, int idx);
+    void writeLabel(const std::string &label);
+    void writeGoto(const std::string &label);
+    void writeIf(const std::string &label);
+    void writeFunction(const std::string &name, int nLocals);
+    void writeCall(const std::string &name, int nArgs);
+    void writeReturn();
+
+    // calls and returns jump to shared routines, VM$call and VM$return, that
+    // a program needs exactly once; writeRuntime writes them and needsRuntime
+    // tells whether anything written so far jumps to them
+    void writeRuntime();
+    bool needsRuntime() const { return uses_runtime; }
+
+    void close();
+
+    // translates a single typed command
+    void write(const Command &cmd);
+
+    // translates every command of a module, scoping statics to its name
+    void writeModule(const Module &module);
+
+    // translates every remaining command of the parser
+    void code(Parser &parser);
+};
+
+} // namespace vm
@@ -0,0 +1,439 @@
+#include "Interpreter.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace vm {
+
+namespace {
+
+enum Handler : uint16_t {
+    BOOTSTRAP,
+    PUSH_CONSTANT, PUSH_LOCAL, PUSH_ARGUMENT, PUSH_THIS, PUSH_THAT, PUSH_DIRECT,
+    POP_LOCAL, POP_ARGUMENT, POP_THIS, POP_THAT, POP_DIRECT,
+    ADD, SUB, NEG, EQ, GT, LT, AND, OR, NOT,
+    GOTO, IF_GOTO, FUNCTION, CALL, RETURN,
+    HALT, UNDEFINED,
+    // superinstructions, named after the commands they replace
+    LOCAL_CONSTANT_ADD, LOCAL_CONSTANT_SUB, ARGUMENT_CONSTANT_ADD, ARGUMENT_CONSTANT_SUB,
+    CONSTANT_ADD, CONSTANT_SUB, CONSTANT_EQ, CONSTANT_LT, CONSTANT_GT,
+    LOCAL_ADD, ARGUMENT_ADD, DIRECT_ADD, ADD_POP_LOCAL, ADD_POP_DIRECT,
+    NOT_IF_GOTO, EQ_NOT_IF_GOTO, LT_NOT_IF_GOTO, GT_NOT_IF_GOTO,
+    THAT_READ,
+    HANDLER_COUNT
+};
+
+// the longest superinstruction, in commands
+constexpr uint64_t MAX_FUSED = 3;
+
+// a command sequence and the superinstruction replacing it; pointer only
+// matches pop pointer 1, the store to THAT of an array access
+struct Pattern {
+    Handler fused;
+    std::vector<Handler> commands;
+    bool pointer = false;
+};
+
+// longer patterns first, so they win over their prefixes
+const Pattern patterns[] = {
+    {LOCAL_CONSTANT_ADD,    {PUSH_LOCAL, PUSH_CONSTANT, ADD}},
+    {LOCAL_CONSTANT_SUB,    {PUSH_LOCAL, PUSH_CONSTANT, SUB}},
+    {ARGUMENT_CONSTANT_ADD, {PUSH_ARGUMENT, PUSH_CONSTANT, ADD}},
+    {ARGUMENT_CONSTANT_SUB, {PUSH_ARGUMENT, PUSH_CONSTANT, SUB}},
+    {EQ_NOT_IF_GOTO,        {EQ, NOT, IF_GOTO}},
+    {LT_NOT_IF_GOTO,        {LT, NOT, IF_GOTO}},
+    {GT_NOT_IF_GOTO,        {GT, NOT, IF_GOTO}},
+    {CONSTANT_ADD,          {PUSH_CONSTANT, ADD}},
+    {CONSTANT_SUB,          {PUSH_CONSTANT, SUB}},
+    {CONSTANT_EQ,           {PUSH_CONSTANT, EQ}},
+    {CONSTANT_LT,           {PUSH_CONSTANT, LT}},
+    {CONSTANT_GT,           {PUSH_CONSTANT, GT}},
+    {LOCAL_ADD,             {PUSH_LOCAL, ADD}},
+    {ARGUMENT_ADD,          {PUSH_ARGUMENT, ADD}},
+    {DIRECT_ADD,            {PUSH_DIRECT, ADD}},
+    {ADD_POP_LOCAL,         {ADD, POP_LOCAL}},
+    {ADD_POP_DIRECT,        {ADD, POP_DIRECT}},
+    {NOT_IF_GOTO,           {NOT, IF_GOTO}},
+    {THAT_READ,             {POP_DIRECT, PUSH_THAT}, true},
+};
+
+constexpr uint16_t SP = 0, LCL = 1, ARG = 2, THIS = 3, THAT = 4, R13 = 13, R14 = 14;
+
+} // namespace
+
+Interpreter::Interpreter(const std::vector<Module>& modules, bool bootstrap) : ram(32768, 0) {
+    load(modules, bootstrap);
+    fuse();
+}
+
+void Interpreter::load(const std::vector<Module>& modules, bool bootstrap) {
+    std::unordered_map<std::string, uint32_t> functions;
+    std::unordered_map<std::string, uint32_t> labels;
+    std::unordered_map<std::string, uint16_t> statics;
+    std::vector<std::pair<uint32_t, std::string>> jumps; // op, function or scoped label
+
+    if (bootstrap) {
+        ops.push_back({BOOTSTRAP, 0, 0, 0, 0, 0});
+        jumps.emplace_back(ops.size(), "Sys.init");
+        ops.push_back({CALL, 0, 0, 0, 0, 0});
+    }
+
+    // labels are scoped to the enclosing function, which carries over from
+    // one module to the next just like in the translator
+    std::string function;
+    for (const Module& module : modules) {
+        for (const Command& cmd : module.commands) {
+            Op op{0, 0, static_cast<uint16_t>(cmd.arg2), 0, 0, 0};
+            switch (cmd.type) {
+                case CommandType::C_PUSH:
+                case CommandType::C_POP: {
+                    bool push = (cmd.type == CommandType::C_PUSH);
+                    if (cmd.arg1 == "constant" && push) {
+                        op.handler = PUSH_CONSTANT;
+                    } else if (cmd.arg1 == "local") {
+                        op.handler = push ? PUSH_LOCAL : POP_LOCAL;
+                    } else if (cmd.arg1 == "argument") {
+                        op.handler = push ? PUSH_ARGUMENT : POP_ARGUMENT;
+                    } else if (cmd.arg1 == "this") {
+                        op.handler = push ? PUSH_THIS : POP_THIS;
+                    } else if (cmd.arg1 == "that") {
+                        op.handler = push ? PUSH_THAT : POP_THAT;
+                    } else {
+                        // fixed addresses: temp, pointer and static
+                        op.handler = push ? PUSH_DIRECT : POP_DIRECT;
+                        if (cmd.arg1 == "temp") {
+                            op.x = 5 + cmd.arg2;
+                        } else if (cmd.arg1 == "pointer") {
+                            op.x = 3 + cmd.arg2;
+                        } else if (cmd.arg1 == "static") {
+                            auto it = statics.emplace(module.name + "." + std::to_string(cmd.arg2),
+                                                      16 + statics.size()).first;
+                            op.x = it->second;
+                        } else {
+                            throw std::runtime_error("[Error] " + module.name + ": invalid segment for " +
+                                                     (push ? "push: " : "pop: ") + cmd.arg1);
+                        }
+                    }
+                    break;
+                }
+                case CommandType::C_ARITHMETIC: {
+                    static const std::unordered_map<std::string, Handler> arithmetic {
+                        {"add", ADD}, {"sub", SUB}, {"neg", NEG}, {"eq", EQ}, {"gt", GT},
+                        {"lt", LT}, {"and", AND}, {"or", OR}, {"not", NOT}
+                    };
+                    op.handler = arithmetic.at(cmd.arg1);
+                    break;
+                }
+                case CommandType::C_LABEL:
+                    labels.emplace(function + "$" + cmd.arg1, ops.size());
+                    continue;
+                case CommandType::C_GOTO:
+                case CommandType::C_IF:
+                    op.handler = (cmd.type == CommandType::C_GOTO) ? GOTO : IF_GOTO;
+                    jumps.emplace_back(ops.size(), "$" + function + "$" + cmd.arg1);
+                    break;
+                case CommandType::C_FUNCTION:
+                    function = cmd.arg1;
+                    functions.emplace(function, ops.size()); // the first definition wins
+                    op.handler = (function == "Sys.halt") ? HALT : FUNCTION;
+                    break;
+                case CommandType::C_CALL:
+                    op.handler = CALL;
+                    jumps.emplace_back(ops.size(), cmd.arg1);
+                    break;
+                case CommandType::C_RETURN:
+                    op.handler = RETURN;
+                    break;
+            }
+            ops.push_back(op);
+        }
+    }
+    if (ops.size() > 0xFFFF) {
+        throw std::runtime_error("[Error] too many commands for 16-bit return addresses: " +
+                                 std::to_string(ops.size()));
+    }
+
+    // unresolved names stay in the program, like the assembler turning them
+    // into variables, and only fail when reached
+    for (const auto& [index, name] : jumps) {
+        Op& op = ops[index];
+        bool is_label = (name[0] == '$');
+        const auto& table = is_label ? labels : functions;
+        auto it = table.find(is_label ? name.substr(1) : name);
+        if (it == table.end()) {
+            op.handler = UNDEFINED;
+            op.target = undefined.size();
+            undefined.push_back(is_label ? name.substr(1) : name);
+            continue;
+        }
+        op.target = it->second;
+        if (op.handler == GOTO && op.target == index) op.handler = HALT;
+    }
+    for (Op& op : ops) op.base = op.handler;
+}
+
+// a superinstruction replaces the first command of its sequence and carries
+// the operands of all of them; the other commands stay in place, so jumps
+// into the middle of the sequence still work
+void Interpreter::fuse() {
+    for (size_t i = 0; i < ops.size(); ++i) {
+        for (const Pattern& pattern : patterns) {
+            size_t length = pattern.commands.size();
+            if (i + length > ops.size()) continue;
+            bool match = true;
+            for (size_t k = 0; k < length && match; ++k) {
+                match = (ops[i + k].base == pattern.commands[k]);
+            }
+            if (!match || (pattern.pointer && ops[i].x != 4)) continue;
+
+            Op& op = ops[i];
+            op.handler = pattern.fused;
+            if (length > 1) op.y = ops[i + 1].x;
+            if (length > 2) op.z = ops[i + 2].x;
+            op.target = ops[i + length - 1].target;
+            ++fused;
+            break;
+        }
+    }
+}
+
+uint64_t Interpreter::run(uint64_t steps) {
+    uint16_t* const mem = ram.data();
+    const Op* const code = ops.data();
+    uint32_t pc = this->pc;
+    const Op* op = nullptr;
+    uint64_t executed = 0;
+    // superinstructions run several commands at once; near the end of the
+    // budget only plain commands are dispatched so it is never overrun
+    const uint64_t fused_limit = (steps >= MAX_FUSED) ? steps - (MAX_FUSED - 1) : 0;
+
+#define RAM(address) mem[(address) & 0x7FFF]
+#define PUSH(value) do { uint16_t v_ = (value); RAM(mem[SP]) = v_; ++mem[SP]; } while (0)
+#define TOP RAM(mem[SP] - 1)
+#define POP() (--mem[SP], RAM(mem[SP]))
+
+#if defined(__GNUC__)
+    // threaded dispatch through GCC's labels as values; same order as Handler
+    static void* const handlers[HANDLER_COUNT] = {
+        &&h_BOOTSTRAP,
+        &&h_PUSH_CONSTANT, &&h_PUSH_LOCAL, &&h_PUSH_ARGUMENT, &&h_PUSH_THIS, &&h_PUSH_THAT, &&h_PUSH_DIRECT,
+        &&h_POP_LOCAL, &&h_POP_ARGUMENT, &&h_POP_THIS, &&h_POP_THAT, &&h_POP_DIRECT,
+        &&h_ADD, &&h_SUB, &&h_NEG, &&h_EQ, &&h_GT, &&h_LT, &&h_AND, &&h_OR, &&h_NOT,
+        &&h_GOTO, &&h_IF_GOTO, &&h_FUNCTION, &&h_CALL, &&h_RETURN,
+        &&h_HALT, &&h_UNDEFINED,
+        &&h_LOCAL_CONSTANT_ADD, &&h_LOCAL_CONSTANT_SUB, &&h_ARGUMENT_CONSTANT_ADD, &&h_ARGUMENT_CONSTANT_SUB,
+        &&h_CONSTANT_ADD, &&h_CONSTANT_SUB, &&h_CONSTANT_EQ, &&h_CONSTANT_LT, &&h_CONSTANT_GT,
+        &&h_LOCAL_ADD, &&h_ARGUMENT_ADD, &&h_DIRECT_ADD, &&h_ADD_POP_LOCAL, &&h_ADD_POP_DIRECT,
+        &&h_NOT_IF_GOTO, &&h_EQ_NOT_IF_GOTO, &&h_LT_NOT_IF_GOTO, &&h_GT_NOT_IF_GOTO,
+        &&h_THAT_READ,
+    };
+#define HANDLER(name) h_##name:
+#define DISPATCH()                                                          \
+    do {                                                                    \
+        if (executed >= steps) goto done;                                   \
+        op = &code[pc];                                                     \
+        goto *handlers[executed < fused_limit ? op->handler : op->base];    \
+    } while (0)
+
+    DISPATCH();
+#else
+#define HANDLER(name) case name:
+#define DISPATCH() continue
+
+    for (;;) {
+        if (executed >= steps) goto done;
+        op = &code[pc];
+        switch (executed < fused_limit ? op->handler : op->base) {
+#endif
+
+// a plain command: one step, continue with the next
+#define NEXT() do { ++executed; ++pc; DISPATCH(); } while (0)
+
+    HANDLER(BOOTSTRAP)
+        mem[SP] = 256;
+        ++pc;
+        DISPATCH(); // part of the call that follows, not a command of its own
+
+    HANDLER(PUSH_CONSTANT) PUSH(op->x); NEXT();
+    HANDLER(PUSH_LOCAL)    PUSH(RAM(mem[LCL] + op->x)); NEXT();
+    HANDLER(PUSH_ARGUMENT) PUSH(RAM(mem[ARG] + op->x)); NEXT();
+    HANDLER(PUSH_THIS)     PUSH(RAM(mem[THIS] + op->x)); NEXT();
+    HANDLER(PUSH_THAT)     PUSH(RAM(mem[THAT] + op->x)); NEXT();
+    HANDLER(PUSH_DIRECT)   PUSH(mem[op->x]); NEXT();
+
+    // the translator computes the address into R13 before popping
+#define POP_TO(base) do { mem[R13] = mem[base] + op->x; uint16_t v_ = POP(); RAM(mem[R13]) = v_; } while (0)
+    HANDLER(POP_LOCAL)     POP_TO(LCL); NEXT();
+    HANDLER(POP_ARGUMENT)  POP_TO(ARG); NEXT();
+    HANDLER(POP_THIS)      POP_TO(THIS); NEXT();
+    HANDLER(POP_THAT)      POP_TO(THAT); NEXT();
+    HANDLER(POP_DIRECT)    { uint16_t v_ = POP(); mem[op->x] = v_; } NEXT();
+
+    // eq, gt and lt test x - y like the translated code, overflow included
+#define BINARY(expr) do { uint16_t y = POP(); uint16_t& x = TOP; x = (expr); } while (0)
+    HANDLER(ADD) BINARY(x + y); NEXT();
+    HANDLER(SUB) BINARY(x - y); NEXT();
+    HANDLER(AND) BINARY(x & y); NEXT();
+    HANDLER(OR)  BINARY(x | y); NEXT();
+    HANDLER(EQ)  BINARY(static_cast<uint16_t>(x - y) == 0 ? 0xFFFF : 0); NEXT();
+    HANDLER(GT)  BINARY(static_cast<int16_t>(x - y) > 0 ? 0xFFFF : 0); NEXT();
+    HANDLER(LT)  BINARY(static_cast<int16_t>(x - y) < 0 ? 0xFFFF : 0); NEXT();
+    HANDLER(NEG) TOP = -TOP; NEXT();
+    HANDLER(NOT) TOP = ~TOP; NEXT();
+
+    HANDLER(GOTO)
+        ++executed;
+        pc = op->target;
+        DISPATCH();
+    HANDLER(IF_GOTO)
+        ++executed;
+        pc = POP() ? op->target : pc + 1;
+        DISPATCH();
+
+    HANDLER(FUNCTION)
+        for (uint16_t i = 0; i < op->x; ++i) PUSH(0);
+        NEXT();
+
+    HANDLER(CALL) {
+        uint16_t frame = mem[SP];
+        mem[R13] = op->x;
+        mem[R14] = static_cast<uint16_t>(op->target);
+        PUSH(pc + 1);
+        PUSH(mem[LCL]);
+        PUSH(mem[ARG]);
+        PUSH(mem[THIS]);
+        PUSH(mem[THAT]);
+        mem[ARG] = frame - op->x;
+        mem[LCL] = mem[SP];
+        ++executed;
+        pc = op->target;
+        DISPATCH();
+    }
+
+    HANDLER(RETURN) {
+        uint16_t frame = mem[LCL];
+        mem[R14] = RAM(frame - 5);
+        uint16_t result = POP();
+        RAM(mem[ARG]) = result;
+        mem[SP] = mem[ARG] + 1;
+        mem[THAT] = RAM(frame - 1);
+        mem[THIS] = RAM(frame - 2);
+        mem[ARG] = RAM(frame - 3);
+        mem[LCL] = RAM(frame - 4);
+        mem[R13] = frame - 4;
+        ++executed;
+        pc = mem[R14];
+        if (pc >= ops.size()) {
+            this->pc = pc;
+            throw std::runtime_error("[Error] return to invalid address " + std::to_string(pc));
+        }
+        DISPATCH();
+    }
+
+    HANDLER(HALT)
+        is_halted = true;
+        goto done;
+
+    HANDLER(UNDEFINED)
+        this->pc = pc;
+        throw std::runtime_error("[Error] jump to undefined function or label: " + undefined[op->target]);
+
+    // superinstructions leave RAM exactly as their commands would, including
+    // the stack slots they pushed and popped
+#define SKIP(n) do { executed += (n); pc += (n); DISPATCH(); } while (0)
+#define PUSH_PLUS(base, expr)                       \
+    do {                                            \
+        uint16_t x = RAM(mem[base] + op->x);        \
+        RAM(mem[SP]) = x;                           \
+        RAM(mem[SP] + 1) = op->y;                   \
+        RAM(mem[SP]) = (expr);                      \
+        ++mem[SP];                                  \
+    } while (0)
+    HANDLER(LOCAL_CONSTANT_ADD)    PUSH_PLUS(LCL, x + op->y); SKIP(3);
+    HANDLER(LOCAL_CONSTANT_SUB)    PUSH_PLUS(LCL, x - op->y); SKIP(3);
+    HANDLER(ARGUMENT_CONSTANT_ADD) PUSH_PLUS(ARG, x + op->y); SKIP(3);
+    HANDLER(ARGUMENT_CONSTANT_SUB) PUSH_PLUS(ARG, x - op->y); SKIP(3);
+
+#define WITH_OPERAND(value, expr)                   \
+    do {                                            \
+        uint16_t y = (value);                       \
+        RAM(mem[SP]) = y;                           \
+        uint16_t& x = TOP;                          \
+        x = (expr);                                 \
+    } while (0)
+    HANDLER(CONSTANT_ADD) WITH_OPERAND(op->x, x + y); SKIP(2);
+    HANDLER(CONSTANT_SUB) WITH_OPERAND(op->x, x - y); SKIP(2);
+    HANDLER(CONSTANT_EQ)  WITH_OPERAND(op->x, static_cast<uint16_t>(x - y) == 0 ? 0xFFFF : 0); SKIP(2);
+    HANDLER(CONSTANT_LT)  WITH_OPERAND(op->x, static_cast<int16_t>(x - y) < 0 ? 0xFFFF : 0); SKIP(2);
+    HANDLER(CONSTANT_GT)  WITH_OPERAND(op->x, static_cast<int16_t>(x - y) > 0 ? 0xFFFF : 0); SKIP(2);
+    HANDLER(LOCAL_ADD)    WITH_OPERAND(RAM(mem[LCL] + op->x), x + y); SKIP(2);
+    HANDLER(ARGUMENT_ADD) WITH_OPERAND(RAM(mem[ARG] + op->x), x + y); SKIP(2);
+    HANDLER(DIRECT_ADD)   WITH_OPERAND(mem[op->x], x + y); SKIP(2);
+
+    HANDLER(ADD_POP_LOCAL) {
+        BINARY(x + y);
+        mem[R13] = mem[LCL] + op->y;
+        uint16_t v_ = POP();
+        RAM(mem[R13]) = v_;
+        SKIP(2);
+    }
+    HANDLER(ADD_POP_DIRECT) {
+        BINARY(x + y);
+        uint16_t v_ = POP();
+        mem[op->y] = v_;
+        SKIP(2);
+    }
+
+    // the comparison result and its negation are left in the popped slot
+#define BRANCH_UNLESS(test)                                     \
+    do {                                                        \
+        uint16_t y = POP();                                     \
+        uint16_t x = POP();                                     \
+        uint16_t result = (test) ? 0 : 0xFFFF;                  \
+        RAM(mem[SP]) = result;                                  \
+        executed += 3;                                          \
+        pc = result ? op->target : pc + 3;                      \
+        (void)y;                                                \
+        DISPATCH();                                             \
+    } while (0)
+    HANDLER(EQ_NOT_IF_GOTO) BRANCH_UNLESS(static_cast<uint16_t>(x - y) == 0);
+    HANDLER(LT_NOT_IF_GOTO) BRANCH_UNLESS(static_cast<int16_t>(x - y) < 0);
+    HANDLER(GT_NOT_IF_GOTO) BRANCH_UNLESS(static_cast<int16_t>(x - y) > 0);
+    HANDLER(NOT_IF_GOTO) {
+        uint16_t& top = TOP;
+        top = ~top;
+        executed += 2;
+        pc = POP() ? op->target : pc + 2;
+        DISPATCH();
+    }
+
+    HANDLER(THAT_READ) {
+        mem[THAT] = POP();
+        PUSH(RAM(mem[THAT] + op->y));
+        SKIP(2);
+    }
+
+#if !defined(__GNUC__)
+        }
+    }
+#endif
+
+done:
+#undef HANDLER
+#undef DISPATCH
+#undef NEXT
+#undef RAM
+#undef PUSH
+#undef TOP
+#undef POP
+#undef POP_TO
+#undef BINARY
+#undef SKIP
+#undef PUSH_PLUS
+#undef WITH_OPERAND
+#undef BRANCH_UNLESS
+    this->pc = pc;
+    return executed;
+}
+
+} // namespace vm
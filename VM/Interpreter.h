@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "VMCommand.h"
+
+namespace vm {
+
+// runs VM code directly on the Hack memory map, without translating it to
+// assembly. Labels and calls are resolved to command indices once, common
+// command sequences are fused into superinstructions, and the run loop uses
+// threaded dispatch.
+//
+// RAM ends up as the assembled program leaves it: SP/LCL/ARG/THIS/THAT live in
+// RAM 0-4, temp in 5-12, R13/R14 are set like the translator's pop, call and
+// return code (a call leaves nArgs in R13 and the function in R14, as it
+// passes them to VM$call), and statics get addresses from 16 up in order of
+// first appearance. Only code addresses differ: the saved return addresses
+// and R14 are command indices instead of ROM addresses.
+class Interpreter {
+public:
+    // modules run in the given order; with bootstrap, SP is set to 256 and
+    // Sys.init is called first, as CodeWriter::writeInit does
+    Interpreter(const std::vector<Module>& modules, bool bootstrap);
+
+    // executes at most steps VM commands and returns how many ran; stops early
+    // when Sys.halt is called or at a "label L; goto L" loop
+    uint64_t run(uint64_t steps);
+
+    bool halted() const { return is_halted; }
+
+    // commands loaded, and how many of them start a superinstruction
+    size_t commandCount() const { return ops.size(); }
+    size_t fusedCount() const { return fused; }
+
+    std::vector<uint16_t> ram;
+
+private:
+    struct Op {
+        uint16_t handler;
+        uint16_t base;   // handler of the command alone, before fusing
+        uint16_t x;      // constant, segment index, nVars or nArgs
+        uint16_t y;      // second operand of a superinstruction
+        uint16_t z;      // third operand of a superinstruction
+        uint32_t target; // jump target or called function
+    };
+
+    std::vector<Op> ops;
+    std::vector<std::string> undefined; // names of unresolved calls and jumps
+    uint32_t pc = 0;
+    bool is_halted = false;
+    size_t fused = 0;
+
+    void load(const std::vector<Module>& modules, bool bootstrap);
+    void fuse();
+};
+
+} // namespace vm
@@ -0,0 +1,62 @@
+#include "NativeBodies.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <functional>
+
+namespace vm {
+
+NativeBodies::NativeBodies(const std::string& dir) {
+    namespace fs = std::filesystem;
+    if (!fs::is_directory(dir)) {
+        throw std::runtime_error("[Error] native body directory not found: " + dir);
+    }
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".asm") continue;
+        std::string path = entry.path().string();
+        std::string function = entry.path().stem().string();
+        if (function.find('.') == std::string::npos) {
+            throw std::runtime_error("[Error] " + path + ": native bodies are named <Class>.<function>.asm");
+        }
+
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("[Error] unable to open native body " + path);
+        }
+        std::string code, line;
+        unsigned int line_number = 0;
+        while (std::getline(in, line)) {
+            ++line_number;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t start = line.find_first_not_of(" \t");
+            if (start != std::string::npos && line[start] == '(') {
+                std::string label = line.substr(start + 1, line.find(')', start) - start - 1);
+                if (label.rfind(function + "$", 0) != 0) {
+                    throw std::runtime_error("[Error] " + path + ":" + std::to_string(line_number) + ": label (" + label +
+                                             ") has to start with " + function + "$");
+                }
+            }
+            code += line;
+            code += '\n';
+        }
+        bodies[function] = std::move(code);
+    }
+}
+
+const std::string* NativeBodies::find(const std::string& function) const {
+    auto it = bodies.find(function);
+    return it == bodies.end() ? nullptr : &it->second;
+}
+
+std::string NativeBodies::stamp(const std::string& class_name) const {
+    std::ostringstream out;
+    std::string prefix = class_name + ".";
+    for (auto it = bodies.lower_bound(prefix); it != bodies.end() && it->first.rfind(prefix, 0) == 0; ++it) {
+        out << " native " << it->first << ":" << std::hex << std::hash<std::string>{}(it->second);
+    }
+    return out.str();
+}
+
+} // namespace vm
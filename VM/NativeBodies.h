@@ -0,0 +1,37 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace vm {
+
+// hand-written Hack assembly for VM functions, read from a directory with one
+// <Class>.<function>.asm file per function. The CodeWriter puts a body at the
+// entry label of its function; the function's translated code follows under
+// the label <function>$$vm (VM labels can't hold a $), for the body to jump
+// to on cases it leaves to the VM code, with the frame as it found it.
+//
+// A body is entered the way the VM call leaves it: the arguments at ARG[0..],
+// the caller's return address, LCL, ARG, THIS and THAT saved just below LCL,
+// SP = LCL and no locals pushed. It returns the way the VM return does: the
+// result in ARG[0], SP = ARG + 1, THAT, THIS, ARG and LCL restored from the
+// frame and a jump to the return address. In between it may use R13-R15 and
+// the stack above SP. Its labels have to start with <function>$.
+class NativeBodies {
+    std::map<std::string, std::string> bodies; // code by function name
+
+public:
+    NativeBodies() = default;
+    explicit NativeBodies(const std::string& dir);
+
+    // the body of a function, or nullptr to translate its VM code
+    const std::string* find(const std::string& function) const;
+
+    size_t size() const { return bodies.size(); }
+
+    // identifies the bodies of one class and their contents, so a build
+    // cache can tell when an object made with them is stale
+    std::string stamp(const std::string& class_name) const;
+};
+
+} // namespace vm
@@ -0,0 +1,128 @@
+#include "Parser.h"
+
+#include <iostream>
+#include <sstream>
+#include <filesystem>
+
+namespace vm {
+
+const std::unordered_map<std::string, CommandType> Parser::defined_command_types {
+    {"add", CommandType::C_ARITHMETIC},  {"sub", CommandType::C_ARITHMETIC},  {"neg", CommandType::C_ARITHMETIC},
+    {"eq", CommandType::C_ARITHMETIC},   {"gt", CommandType::C_ARITHMETIC},   {"lt", CommandType::C_ARITHMETIC},
+    {"and", CommandType::C_ARITHMETIC},  {"or", CommandType::C_ARITHMETIC},   {"not", CommandType::C_ARITHMETIC},
+    {"push", CommandType::C_PUSH},       {"pop", CommandType::C_POP},         {"label", CommandType::C_LABEL},
+    {"goto", CommandType::C_GOTO},       {"if-goto", CommandType::C_IF},      {"function", CommandType::C_FUNCTION},
+    {"call", CommandType::C_CALL},       {"return", CommandType::C_RETURN}
+};
+
+std::string Parser::trim(const std::string &s) {
+    auto start = s.find_first_not_of(" \t\n\r");
+    if (start == std::string::npos) return "";
+    auto end = s.find_last_not_of(" \t\n\r");
+    return s.substr(start, end - start + 1);
+}
+
+Parser::Parser(const std::string& file)
+    : in(vm_file), source_name(std::filesystem::path(file).filename().string()) {
+    vm_file.open(file);
+    if (!vm_file.is_open()) {
+        throw std::runtime_error("[Error] unable to open input VM file: " + file);
+    }
+}
+
+Parser::Parser(std::istream& stream) : in(stream) {}
+
+Parser::~Parser() {
+    if (vm_file.is_open())
+        vm_file.close();
+}
+
+bool Parser::hasMoreCommands() {
+    return in.peek() != EOF;
+}
+
+void Parser::advance() {
+    current_command.clear();
+    while (std::getline(in, current_command)) {
+        ++line_number;
+        auto pos = current_command.find("//");
+        if (pos != std::string::npos)
+            current_command = current_command.substr(0, pos);
+        current_command = trim(current_command);
+        if (!current_command.empty()) return;
+    }
+    current_command.clear();
+}
+
+std::string Parser::commandTokenizer() const {
+    auto pos = current_command.find(' ');
+    return (pos == std::string::npos) ? current_command
+                                      : current_command.substr(0, pos);
+}
+
+CommandType Parser::commandType() const {
+    auto it = defined_command_types.find(commandTokenizer());
+    if (it == defined_command_types.end()) {
+        throw std::runtime_error("Unknown command: " + commandTokenizer());
+    }
+    return it->second;
+}
+
+std::string Parser::arg1() const {
+    CommandType type = commandType();
+    if (type == CommandType::C_ARITHMETIC) {
+        return commandTokenizer();
+    } else if (type != CommandType::C_RETURN) {
+        std::istringstream iss(current_command);
+        std::string cmd, arg;
+        iss >> cmd >> arg;
+        if (!iss || arg.empty()) {
+            throw std::runtime_error("arg1(): failed to parse command: " + current_command);
+        }
+        return arg;
+    }
+    throw std::invalid_argument("arg1() called on return or invalid command");
+}
+
+int Parser::arg2() const {
+    CommandType type = commandType();
+    if (type == CommandType::C_PUSH || type == CommandType::C_POP ||
+        type == CommandType::C_FUNCTION || type == CommandType::C_CALL) {
+        std::istringstream iss(current_command);
+        std::string cmd, arg1;
+        int arg2;
+        iss >> cmd >> arg1 >> arg2;
+        if (!iss) {
+            throw std::runtime_error("arg2(): failed to parse command: " + current_command);
+        }
+        return arg2;
+    }
+    throw std::invalid_argument("arg2() called on command without arg");
+}
+
+Command Parser::command() const {
+    Command cmd{commandType(), "", 0, line_number};
+    switch (cmd.type) {
+        case CommandType::C_RETURN:
+            break;
+        case CommandType::C_PUSH: case CommandType::C_POP:
+        case CommandType::C_FUNCTION: case CommandType::C_CALL:
+            cmd.arg2 = arg2();
+            [[fallthrough]];
+        default:
+            cmd.arg1 = arg1();
+    }
+    return cmd;
+}
+
+Module Parser::parseModule(const std::string& name) {
+    Module module{name, {}, source_name};
+    while (hasMoreCommands()) {
+        advance();
+        if (current_command.empty()) continue;
+        module.commands.push_back(command());
+    }
+    return module;
+}
+
+} // namespace vm
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <istream>
+#include <unordered_map>
+#include <stdexcept>
+
+#include "VMCommand.h"
+
+namespace vm {
+
+// reads VM commands one line at a time from a .vm file or any input stream
+class Parser {
+private:
+    std::ifstream vm_file; // only used when constructed from a path
+    std::istream& in;
+    std::string source_name; // file name of the input, empty for a stream
+
+    static const std::unordered_map<std::string, CommandType> defined_command_types;
+
+    static std::string trim(const std::string &s);
+
+public:
+    std::string current_command;
+    unsigned int line_number = 0; // line of current_command
+
+    explicit Parser(const std::string& file);
+    explicit Parser(std::istream& stream);
+    ~Parser();
+
+    bool hasMoreCommands();
+
+    // reads the next command, skipping blank lines and comments
+    void advance();
+
+    std::string commandTokenizer() const;
+    CommandType commandType() const;
+    std::string arg1() const;
+    int arg2() const;
+
+    // the current command in typed form
+    Command command() const;
+
+    // parses every remaining command into a module named name
+    Module parseModule(const std::string& name);
+};
+
+} // namespace vm
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+// typed representation of VM code, shared by the VM translator and by any
+// front end (the Jack compiler, the build driver) that wants to hand VM code
+// over in memory instead of through .vm text files.
+
+namespace vm {
+
+enum class CommandType {
+    C_ARITHMETIC,
+    C_PUSH, C_POP,
+    C_LABEL, C_GOTO, C_IF,
+    C_FUNCTION, C_CALL, C_RETURN
+};
+
+struct Command {
+    CommandType type;
+    std::string arg1; // arithmetic op, segment, label or function name
+    int arg2 = 0;     // index (push/pop), nVars (function) or nArgs (call)
+    unsigned int line = 0; // line in the module's source it came from, 0 if unknown
+};
+
+// all commands of one Xxx.vm file; name is Xxx and scopes its static segment
+struct Module {
+    std::string name;
+    std::vector<Command> commands;
+    std::string source; // file the command lines refer to, Xxx.vm if empty
+};
+
+// writes a command back in .vm text form (without trailing newline)
+inline std::ostream& operator<<(std::ostream& os, const Command& c) {
+    switch (c.type) {
+        case CommandType::C_ARITHMETIC: return os << c.arg1;
+        case CommandType::C_PUSH:       return os << "push " << c.arg1 << " " << c.arg2;
+        case CommandType::C_POP:        return os << "pop " << c.arg1 << " " << c.arg2;
+        case CommandType::C_LABEL:      return os << "label " << c.arg1;
+        case CommandType::C_GOTO:       return os << "goto " << c.arg1;
+        case CommandType::C_IF:         return os << "if-goto " << c.arg1;
+        case CommandType::C_FUNCTION:   return os << "function " << c.arg1 << " " << c.arg2;
+        case CommandType::C_CALL:       return os << "call " << c.arg1 << " " << c.arg2;
+        case CommandType::C_RETURN:     return os << "return";
+    }
+    return os;
+}
+
+} // namespace vm
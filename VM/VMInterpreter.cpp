@@ -0,0 +1,110 @@
+// VMInterpreter.cpp
+// Runs Hack VM files directly, without translating and assembling them.
+// Takes the same input as the VM translator: a single .vm file or a directory,
+// whose files run in sorted order behind the bootstrap code if there is more than one.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+#include "Parser.h"
+#include "Interpreter.h"
+#include "../assembler/RomImage.h"
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <input_file.vm | input_directory> [--max-steps <n>] [--dump <ram file>]\n"
+              << "  --max-steps <n>   stop after n VM commands (default: 100000000)\n"
+              << "  --dump <file>     write all 32K RAM words on exit, in the ROM image format\n"
+              << "                    given by the extension (.hack, .bin or .hex)\n"
+              << "  execution also stops when Sys.halt is called\n";
+}
+
+int main(int argc, char *argv[]) {
+    namespace fs = std::filesystem;
+    fs::path input_path;
+    std::string dump_path;
+    uint64_t max_steps = 100000000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max-steps" && i + 1 < argc) {
+            max_steps = std::stoull(argv[++i]);
+        } else if (arg == "--dump" && i + 1 < argc) {
+            dump_path = argv[++i];
+        } else if (input_path.empty() && !arg.empty() && arg[0] != '-') {
+            input_path = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (input_path.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<fs::path> vm_files;
+    if (fs::is_directory(input_path)) {
+        for (const auto &entry : fs::directory_iterator(input_path)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".vm") {
+                vm_files.push_back(entry.path());
+            }
+        }
+    } else if (fs::is_regular_file(input_path) && input_path.extension() == ".vm") {
+        vm_files.push_back(input_path);
+    } else {
+        std::cerr << "[Error] Input must be a .vm file or a directory.\n";
+        return 1;
+    }
+    if (vm_files.empty()) {
+        std::cerr << "[Error] No .vm files found to run.\n";
+        return 1;
+    }
+    std::sort(vm_files.begin(), vm_files.end());
+
+    try {
+        std::vector<vm::Module> modules;
+        for (const auto &vm_file : vm_files) {
+            vm::Parser parser(vm_file.string());
+            modules.push_back(parser.parseModule(vm_file.stem().string()));
+        }
+        vm::Interpreter interpreter(modules, vm_files.size() > 1);
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t steps = interpreter.run(max_steps);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const auto& ram = interpreter.ram;
+        std::cout << (interpreter.halted() ? "Halted" : "Step limit reached") << " after " << steps
+                  << " VM commands\n"
+                  << "  " << std::fixed << std::setprecision(2) << seconds * 1000 << " ms, "
+                  << (seconds > 0 ? steps / seconds / 1e6 : 0.0) << " million commands per second\n"
+                  << "  " << interpreter.fusedCount() << " of " << interpreter.commandCount()
+                  << " commands start a superinstruction\n"
+                  << "  SP " << ram[0] << "  LCL " << ram[1] << "  ARG " << ram[2]
+                  << "  THIS " << ram[3] << "  THAT " << ram[4] << "\n";
+
+        if (!dump_path.empty()) {
+            std::string extension = fs::path(dump_path).extension().string();
+            assembler::RomFormat format = (extension == ".bin") ? assembler::RomFormat::BIN
+                                        : (extension == ".hex") ? assembler::RomFormat::HEX
+                                                                : assembler::RomFormat::ASCII;
+            std::ofstream dump_file(dump_path, std::ios::binary);
+            if (!dump_file.is_open()) {
+                std::cerr << "[Error] Unable to create dump file: " << dump_path << "\n";
+                return 1;
+            }
+            assembler::writeRom(ram, format, dump_file);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+# VM interpreter checks: running the VM code directly gives the results and
+# screen of the translated program
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$REPO"
+
+# interpret <name>: runs $WORK/<name>/src, the .vm files hackc --keep-temps
+# wrote, to its halt
+interpret() {
+    "$BIN/VMInterpreter" "$WORK/$1/src" --dump "$WORK/$1.vm.ram.hack" > "$WORK/vminterpreter.log" ||
+        { cat "$WORK/vminterpreter.log" >&2; fail "VMInterpreter $1"; }
+    grep -q "^Halted" "$WORK/vminterpreter.log" || fail "$1 did not halt: $(head -1 "$WORK/vminterpreter.log")"
+}
+
+expected=compiler/test/Features/expected.txt
+# -O only so that hackc accepts the image; the .vm files are the same
+hackc compiler/test/Features -o "$WORK/features/o.hack" --keep-temps -O
+interpret features
+ram "$WORK/features.vm.ram.hack" 8000 "$(wc -l < "$expected")" > "$WORK/features.txt"
+same "Features" "$expected" "$WORK/features.txt"
+
+hackc compiler/test_programs/Seven -o "$WORK/seven/o.hack" --keep-temps
+interpret seven
+run "$WORK/seven/o.hack" 20000000 "$WORK/seven.ram.hack"
+cmp -s <(sed -n '16385,24576p' "$WORK/seven.ram.hack") <(sed -n '16385,24576p' "$WORK/seven.vm.ram.hack") ||
+    fail "Seven draws a different screen interpreted"
+ok "Seven draws the same screen interpreted"
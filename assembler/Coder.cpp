@@ -0,0 +1,109 @@
+#include "Coder.h"
+
+#include <array>
+
+namespace assembler {
+
+namespace {
+
+// comp mnemonics are at most 3 characters over a 10-symbol alphabet, so
+// packing a 4-bit code per character gives a 12-bit perfect hash
+constexpr uint16_t compCharCode(char c) {
+    switch (c) {
+        case '0': return 1;  case '1': return 2;  case '-': return 3;
+        case 'D': return 4;  case 'A': return 5;  case 'M': return 6;
+        case '!': return 7;  case '+': return 8;  case '&': return 9;
+        case '|': return 10;
+        default:  return 15; // never part of a valid mnemonic
+    }
+}
+
+constexpr uint16_t compHash(std::string_view m) {
+    uint16_t key = 0;
+    for (size_t i = 0; i < m.size(); ++i) {
+        key |= compCharCode(m[i]) << (4 * i);
+    }
+    return key;
+}
+
+struct CompEntry {
+    std::string_view mnemonic;
+    uint16_t bits; // a c1 c2 c3 c4 c5 c6
+};
+
+constexpr CompEntry comp_entries[] = {
+    {"0",   0b0101010}, {"1",   0b0111111}, {"-1",  0b0111010},
+    {"D",   0b0001100}, {"A",   0b0110000}, {"M",   0b1110000},
+    {"!D",  0b0001101}, {"!A",  0b0110001}, {"!M",  0b1110001},
+    {"-D",  0b0001111}, {"-A",  0b0110011}, {"-M",  0b1110011},
+    {"D+1", 0b0011111}, {"A+1", 0b0110111}, {"M+1", 0b1110111},
+    {"D-1", 0b0001110}, {"A-1", 0b0110010}, {"M-1", 0b1110010},
+    {"D+A", 0b0000010}, {"D+M", 0b1000010},
+    {"D-A", 0b0010011}, {"D-M", 0b1010011},
+    {"A-D", 0b0000111}, {"M-D", 0b1000111},
+    {"D&A", 0b0000000}, {"D&M", 0b1000000},
+    {"D|A", 0b0010101}, {"D|M", 0b1010101}
+};
+
+constexpr auto comp_table = [] {
+    std::array<uint16_t, 1 << 12> table{};
+    for (auto& entry : table) entry = Coder::INVALID;
+    for (const auto& [mnemonic, bits] : comp_entries) {
+        table[compHash(mnemonic)] = bits << 6;
+    }
+    return table;
+}();
+
+// jump mnemonics all start with J; (c1 * 7 + c2) mod 8 is collision-free over them
+constexpr size_t jumpHash(std::string_view m) {
+    return (static_cast<size_t>(m[1]) * 7 + static_cast<size_t>(m[2])) & 7;
+}
+
+struct JumpEntry {
+    std::string_view mnemonic;
+    uint16_t bits;
+};
+
+constexpr auto jump_table = [] {
+    constexpr JumpEntry entries[] = {
+        {"JGT", 0b001}, {"JEQ", 0b010}, {"JGE", 0b011}, {"JLT", 0b100},
+        {"JNE", 0b101}, {"JLE", 0b110}, {"JMP", 0b111}
+    };
+    std::array<JumpEntry, 8> table{};
+    for (const auto& entry : entries) {
+        table[jumpHash(entry.mnemonic)] = entry;
+    }
+    return table;
+}();
+
+} // namespace
+
+uint16_t Coder::dest(std::string_view mnemonic) {
+    uint16_t bits = 0;
+    for (char c : mnemonic) {
+        if (c == 'A') bits |= 0b100 << 3;
+        else if (c == 'D') bits |= 0b010 << 3;
+        else if (c == 'M') bits |= 0b001 << 3;
+    }
+    return bits;
+}
+
+uint16_t Coder::jump(std::string_view mnemonic) {
+    if (mnemonic.size() != 3 || mnemonic[0] != 'J') return 0;
+    const JumpEntry& entry = jump_table[jumpHash(mnemonic)];
+    return entry.mnemonic == mnemonic ? entry.bits : 0;
+}
+
+uint16_t Coder::comp(std::string_view mnemonic) {
+    if (mnemonic.empty() || mnemonic.size() > 3) return INVALID;
+    return comp_table[compHash(mnemonic)];
+}
+
+uint16_t Coder::encode(std::string_view dest_mnemonic, std::string_view comp_mnemonic,
+                       std::string_view jump_mnemonic) {
+    uint16_t comp_bits = comp(comp_mnemonic);
+    if (comp_bits == INVALID) return INVALID;
+    return C_PREFIX | comp_bits | dest(dest_mnemonic) | jump(jump_mnemonic);
+}
+
+} // namespace assembler
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+namespace assembler {
+
+// translates C-instruction mnemonics to their bit fields, already shifted into
+// place in the 16-bit instruction word. Lookups go through constexpr tables
+// and never allocate.
+class Coder {
+public:
+    static constexpr uint16_t C_PREFIX = 0xE000; // 111 in the top bits
+    static constexpr uint16_t INVALID = 0xFFFF;
+
+    // d1 d2 d3 for A, D, M (any order), in bits 5..3
+    static uint16_t dest(std::string_view mnemonic);
+
+    // j1 j2 j3 in bits 2..0; an empty or unknown mnemonic means no jump
+    static uint16_t jump(std::string_view mnemonic);
+
+    // a c1..c6 in bits 12..6, or INVALID for an unknown mnemonic
+    static uint16_t comp(std::string_view mnemonic);
+
+    // the full C-instruction, or INVALID if comp is unknown
+    static uint16_t encode(std::string_view dest_mnemonic, std::string_view comp_mnemonic,
+                           std::string_view jump_mnemonic);
+};
+
+} // namespace assembler
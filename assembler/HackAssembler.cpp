@@ -0,0 +1,217 @@
+#include "HackAssembler.h"
+
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Parser.h"
+#include "Coder.h"
+#include "SymbolTable.h"
+#include "Instruction.h"
+
+namespace assembler {
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+std::runtime_error error(const Parser& parser, const std::string& message) {
+    return std::runtime_error("[Error] line " + std::to_string(parser.line_number) + ": " +
+                              message + ": " + parser.current_instruction);
+}
+
+Instruction parseInstruction(const Parser& parser, SymbolTable& symbols) {
+    switch (parser.commandType()) {
+        case CommandType::L_COMMAND:
+            return {Instruction::Kind::LABEL, 0, symbols.id(parser.symbol())};
+        case CommandType::A_COMMAND: {
+            std::string_view symbol = parser.symbol();
+            // symbols can't start with a digit, so anything that does is a
+            // constant and has to be all digits, and fit in the 15 bits an
+            // A-instruction has
+            if (!symbol.empty() && isDigit(symbol[0])) {
+                unsigned long value = 0;
+                for (char c : symbol) {
+                    if (!isDigit(c)) throw error(parser, "malformed constant");
+                    value = value * 10 + (c - '0');
+                    if (value > 0x7FFF) throw error(parser, "constant out of range");
+                }
+                return {Instruction::Kind::CONSTANT, static_cast<uint16_t>(value), 0};
+            }
+            return {Instruction::Kind::SYMBOL, 0, symbols.id(symbol)};
+        }
+        case CommandType::C_COMMAND:
+        default: {
+            uint16_t word = Coder::encode(parser.dest(), parser.comp(), parser.jump());
+            if (word == Coder::INVALID) {
+                throw error(parser, "unknown comp mnemonic");
+            }
+            return {Instruction::Kind::COMPUTE, word, 0};
+        }
+    }
+}
+
+// places one instruction, backpatching forward label references
+void emit(const Instruction& instruction, SymbolTable& symbols, std::vector<uint16_t>& code) {
+    switch (instruction.kind) {
+        case Instruction::Kind::LABEL:
+            symbols.define(instruction.symbol, code.size(), code);
+            break;
+        case Instruction::Kind::SYMBOL:
+            code.push_back(symbols.reference(instruction.symbol, code.size()));
+            break;
+        case Instruction::Kind::LOCATION:
+            break;
+        default:
+            code.push_back(instruction.word);
+    }
+}
+
+// with locations, also marks each new "// file:line" comment with a LOCATION
+// record indexing into it
+std::vector<Instruction> parseProgram(std::string_view source, SymbolTable& symbols,
+                                      std::vector<std::string_view>* locations = nullptr) {
+    Parser parser(source);
+    std::vector<Instruction> program;
+    program.reserve(source.size() / 8);
+    unsigned int location_count = 0;
+    while (parser.advance()) {
+        if (locations && parser.location_count != location_count) {
+            location_count = parser.location_count;
+            program.push_back({Instruction::Kind::LOCATION, 0, static_cast<uint32_t>(locations->size())});
+            locations->push_back(parser.location);
+        }
+        program.push_back(parseInstruction(parser, symbols));
+    }
+    return program;
+}
+
+// labels and variables of an encoded program, and the ROM range each
+// LOCATION record covers
+SymbolFile symbolMap(const std::vector<Instruction>& program, const SymbolTable& symbols,
+                     const std::vector<std::string_view>& locations, size_t code_size) {
+    SymbolFile sym;
+    std::vector<bool> is_label(symbols.size(), false);
+    size_t address = 0;
+    for (const Instruction& instruction : program) {
+        switch (instruction.kind) {
+            case Instruction::Kind::LABEL:
+                if (!symbols.isPredefined(instruction.symbol) && !is_label[instruction.symbol]) {
+                    is_label[instruction.symbol] = true;
+                    sym.labels.push_back({symbols.getAddress(instruction.symbol), symbols.name(instruction.symbol)});
+                }
+                break;
+            case Instruction::Kind::LOCATION: {
+                // a range ends where the next one begins
+                if (!sym.lines.empty()) sym.lines.back().end = address;
+                if (!sym.lines.empty() && sym.lines.back().begin == address) sym.lines.pop_back();
+                std::string location(locations[instruction.symbol]);
+                if (!sym.lines.empty() && sym.lines.back().location == location) break;
+                sym.lines.push_back({static_cast<unsigned int>(address), 0, location});
+                break;
+            }
+            default:
+                ++address;
+        }
+    }
+    if (!sym.lines.empty()) sym.lines.back().end = code_size;
+    if (!sym.lines.empty() && sym.lines.back().begin == sym.lines.back().end) sym.lines.pop_back();
+
+    for (uint32_t id = 0; id < symbols.size(); ++id) {
+        if (symbols.isPredefined(id) || is_label[id] || !symbols.isDefined(id)) continue;
+        sym.variables.push_back({symbols.getAddress(id), symbols.name(id)});
+    }
+    auto by_address = [](const SymbolFile::Symbol& a, const SymbolFile::Symbol& b) { return a.address < b.address; };
+    std::stable_sort(sym.labels.begin(), sym.labels.end(), by_address);
+    std::stable_sort(sym.variables.begin(), sym.variables.end(), by_address);
+    return sym;
+}
+
+} // namespace
+
+std::vector<uint16_t> assemble(std::string_view source, bool optimize_code, OptimizerStats* stats,
+                               SymbolFile* symbol_file) {
+    SymbolTable symbols;
+    std::vector<uint16_t> code;
+    code.reserve(source.size() / 8);
+
+    if (!optimize_code && !symbol_file) {
+        Parser parser(source);
+        while (parser.advance()) {
+            emit(parseInstruction(parser, symbols), symbols, code);
+        }
+        symbols.allocateVariables(code); // variables are allocated starting at RAM address 16
+        return code;
+    }
+
+    // the optimizer and the symbol map need the whole program, so parse it first
+    std::vector<std::string_view> locations;
+    std::vector<Instruction> program = parseProgram(source, symbols, symbol_file ? &locations : nullptr);
+    if (optimize_code) {
+        OptimizerStats result = optimize(program, symbols);
+        if (stats) *stats = result;
+    }
+    for (const Instruction& instruction : program) {
+        emit(instruction, symbols, code);
+    }
+    symbols.allocateVariables(code);
+
+    if (symbol_file) {
+        *symbol_file = symbolMap(program, symbols, locations, code.size());
+    }
+    return code;
+}
+
+ObjectFile assembleObject(std::string_view source, bool optimize_code, OptimizerStats* stats) {
+    SymbolTable symbols; // only predefined symbols are ever defined in it
+    std::vector<Instruction> program = parseProgram(source, symbols);
+    if (optimize_code) {
+        // other objects may jump to any label, so none of them can be dropped
+        OptimizerStats result = optimize(program, symbols, true);
+        if (stats) *stats = result;
+    }
+    std::vector<bool> is_label(symbols.size(), false);
+
+    ObjectFile obj;
+    obj.sections.emplace_back();
+    bool after_unconditional_jump = false;
+
+    for (const Instruction& instruction : program) {
+        auto& code = obj.sections.back().code;
+
+        switch (instruction.kind) {
+            case Instruction::Kind::LABEL:
+                // control cannot fall into this label, so a new section may start here
+                if (after_unconditional_jump && !code.empty()) {
+                    obj.sections.emplace_back();
+                }
+                if (!symbols.isDefined(instruction.symbol) && !is_label[instruction.symbol]) {
+                    is_label[instruction.symbol] = true;
+                    obj.symbols.push_back({symbols.name(instruction.symbol),
+                                           static_cast<unsigned int>(obj.sections.size() - 1),
+                                           static_cast<unsigned int>(obj.sections.back().code.size())});
+                }
+                continue;
+            case Instruction::Kind::SYMBOL:
+                if (symbols.isDefined(instruction.symbol)) {
+                    code.push_back(static_cast<uint16_t>(symbols.getAddress(instruction.symbol)));
+                } else {
+                    obj.relocations.push_back({static_cast<unsigned int>(obj.sections.size() - 1),
+                                               static_cast<unsigned int>(code.size()),
+                                               symbols.name(instruction.symbol)});
+                    code.push_back(0);
+                }
+                break;
+            default:
+                code.push_back(instruction.word);
+        }
+        // C-instruction with all three jump bits set (;JMP)
+        after_unconditional_jump = (instruction.kind == Instruction::Kind::COMPUTE &&
+                                    (instruction.word & 0x7) == 0x7);
+    }
+    return obj;
+}
+
+} // namespace assembler
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include "ObjectFile.h"
+#include "RomImage.h"
+#include "Optimizer.h"
+#include "SymbolFile.h"
+
+namespace assembler {
+
+// assembles Hack assembly held in memory into machine code words, in a single
+// pass: forward label references are backpatched once the label is seen, and
+// symbols never defined as labels become variables from RAM 16 upward.
+// With optimize_code the parsed program is first run through optimize(),
+// reporting what it removed into stats when given. With symbol_file, the
+// final address of every label and variable is recorded there along with the
+// ROM ranges under each "// file:line" comment.
+std::vector<uint16_t> assemble(std::string_view source, bool optimize_code = false,
+                               OptimizerStats* stats = nullptr, SymbolFile* symbol_file = nullptr);
+
+// assembles source into a relocatable object instead; labels and variables
+// are left for the linker to resolve.
+ObjectFile assembleObject(std::string_view source, bool optimize_code = false,
+                          OptimizerStats* stats = nullptr);
+
+} // namespace assembler
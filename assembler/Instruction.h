@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace assembler {
+
+// one parsed source line; LOCATION marks where a "// file:line" source
+// comment applied and encodes to nothing
+struct Instruction {
+    enum class Kind : uint8_t { CONSTANT, SYMBOL, COMPUTE, LABEL, LOCATION };
+    Kind kind;
+    uint16_t word;   // CONSTANT: the value, COMPUTE: the encoded instruction
+    uint32_t symbol; // SYMBOL, LABEL: symbol id, LOCATION: index of the location
+};
+
+} // namespace assembler
@@ -0,0 +1,78 @@
+#include "ObjectFile.h"
+
+#include <iomanip>
+#include <stdexcept>
+
+namespace assembler {
+
+void ObjectFile::write(std::ostream& out) const {
+    out << "HOBJ 1\n";
+    out << "sections " << sections.size() << "\n";
+    out << std::hex << std::setfill('0');
+    for (const auto& section : sections) {
+        out << "section " << std::dec << section.code.size() << std::hex << "\n";
+        for (uint16_t word : section.code) {
+            out << std::setw(4) << word << "\n";
+        }
+    }
+    out << std::dec << std::setfill(' ');
+    out << "symbols " << symbols.size() << "\n";
+    for (const auto& symbol : symbols) {
+        out << symbol.name << " " << symbol.section << " " << symbol.offset << "\n";
+    }
+    out << "relocations " << relocations.size() << "\n";
+    for (const auto& reloc : relocations) {
+        out << reloc.section << " " << reloc.offset << " " << reloc.name << "\n";
+    }
+}
+
+static void expect(std::istream& in, const std::string& keyword) {
+    std::string word;
+    if (!(in >> word) || word != keyword) {
+        throw std::runtime_error("[Error] malformed object file: expected '" + keyword + "'");
+    }
+}
+
+ObjectFile ObjectFile::read(std::istream& in) {
+    ObjectFile obj;
+    unsigned int version = 0, count = 0;
+
+    expect(in, "HOBJ");
+    if (!(in >> version) || version != 1) {
+        throw std::runtime_error("[Error] unsupported object file version");
+    }
+
+    expect(in, "sections");
+    in >> count;
+    obj.sections.resize(count);
+    for (auto& section : obj.sections) {
+        unsigned int size = 0;
+        expect(in, "section");
+        in >> size;
+        section.code.resize(size);
+        for (uint16_t& word : section.code) {
+            in >> std::hex >> word >> std::dec;
+        }
+    }
+
+    expect(in, "symbols");
+    in >> count;
+    obj.symbols.resize(count);
+    for (auto& symbol : obj.symbols) {
+        in >> symbol.name >> symbol.section >> symbol.offset;
+    }
+
+    expect(in, "relocations");
+    in >> count;
+    obj.relocations.resize(count);
+    for (auto& reloc : obj.relocations) {
+        in >> reloc.section >> reloc.offset >> reloc.name;
+    }
+
+    if (!in) {
+        throw std::runtime_error("[Error] malformed object file: unexpected end of file");
+    }
+    return obj;
+}
+
+} // namespace assembler
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace assembler {
+
+// relocatable Hack object (.hobj), produced by the assembler with -c and
+// combined into a .hack image by the linker.
+//
+// Code is split into sections at every label that follows an unconditional
+// jump, so control can only enter a section through one of its labels (or by
+// falling through from the previous section when it does not end in a jump).
+// A-instructions naming a label or variable are emitted as 0 and listed in
+// relocations; predefined symbols and constants are encoded in place.
+struct ObjectFile {
+    struct Section {
+        std::vector<uint16_t> code;
+    };
+
+    // a label, at offset within section
+    struct Symbol {
+        std::string name;
+        unsigned int section;
+        unsigned int offset;
+    };
+
+    // the A-instruction at offset within section loads the address of name
+    struct Relocation {
+        unsigned int section;
+        unsigned int offset;
+        std::string name;
+    };
+
+    std::vector<Section> sections;
+    std::vector<Symbol> symbols;
+    std::vector<Relocation> relocations;
+
+    // text format:
+    //   HOBJ 1
+    //   sections <n>, then per section: section <size> and one hex word per line
+    //   symbols <n>, then per symbol: <name> <section> <offset>
+    //   relocations <n>, then per relocation: <section> <offset> <name>
+    void write(std::ostream& out) const;
+    static ObjectFile read(std::istream& in);
+};
+
+} // namespace assembler
@@ -0,0 +1,188 @@
+#include "Optimizer.h"
+
+#include <unordered_map>
+
+namespace assembler {
+
+namespace {
+
+constexpr uint16_t JUMP_BITS = 0x0007;
+constexpr uint16_t DEST_A = 0x0020;
+constexpr uint16_t DEST_BITS = 0x0038;
+constexpr uint16_t ZY_BIT = 0x0200;       // comp ignores A/M when zy is set
+constexpr uint16_t GOTO_WORD = 0xEA87;    // 0;JMP
+
+bool isCompute(const Instruction& in) { return in.kind == Instruction::Kind::COMPUTE; }
+bool isLoad(const Instruction& in) {
+    return in.kind == Instruction::Kind::CONSTANT || in.kind == Instruction::Kind::SYMBOL;
+}
+bool isMarker(const Instruction& in) {
+    return in.kind == Instruction::Kind::LABEL || in.kind == Instruction::Kind::LOCATION;
+}
+bool isUnconditionalJump(const Instruction& in) {
+    return isCompute(in) && (in.word & JUMP_BITS) == JUMP_BITS;
+}
+
+class Pass {
+    std::vector<Instruction>& program;
+    const SymbolTable& symbols;
+    bool every_label_live;
+    std::vector<int> label_pos; // per symbol id: index of its defining label, or -1
+
+public:
+    OptimizerStats stats;
+
+    Pass(std::vector<Instruction>& program, const SymbolTable& symbols, bool every_label_live)
+        : program(program), symbols(symbols), every_label_live(every_label_live) {}
+
+    bool isLabel(uint32_t id) const {
+        return id < label_pos.size() && label_pos[id] >= 0;
+    }
+
+    void findLabels() {
+        label_pos.assign(symbols.size(), -1);
+        for (size_t i = 0; i < program.size(); ++i) {
+            const Instruction& in = program[i];
+            // predefined symbols cannot be redefined, and the first definition wins
+            if (in.kind == Instruction::Kind::LABEL && !symbols.isDefined(in.symbol) && label_pos[in.symbol] < 0) {
+                label_pos[in.symbol] = i;
+            }
+        }
+    }
+
+    // where execution continues after jumping to label: past any trampolines
+    uint32_t finalTarget(uint32_t label) const {
+        for (int hops = 0; hops < 16; ++hops) {
+            size_t p = label_pos[label];
+            while (p < program.size() && isMarker(program[p])) ++p;
+            if (p + 1 >= program.size()) break;
+            const Instruction& load = program[p];
+            if (load.kind != Instruction::Kind::SYMBOL || !isLabel(load.symbol) ||
+                program[p + 1].kind != Instruction::Kind::COMPUTE || program[p + 1].word != GOTO_WORD ||
+                load.symbol == label) {
+                break;
+            }
+            label = load.symbol;
+        }
+        return label;
+    }
+
+    bool threadJumps() {
+        bool changed = false;
+        for (size_t i = 0; i + 1 < program.size(); ++i) {
+            Instruction& load = program[i];
+            const Instruction& jump = program[i + 1];
+            if (load.kind != Instruction::Kind::SYMBOL || !isLabel(load.symbol) || !isCompute(jump) ||
+                (jump.word & JUMP_BITS) == 0 || (jump.word & DEST_BITS) != 0 || !(jump.word & ZY_BIT)) {
+                continue;
+            }
+            // a conditional jump falls through with the old target still in A,
+            // so only thread it when the next instruction reloads A anyway
+            bool unconditional = (jump.word & JUMP_BITS) == JUMP_BITS;
+            size_t next = i + 2;
+            while (next < program.size() && program[next].kind == Instruction::Kind::LOCATION) ++next;
+            if (!unconditional && !(next < program.size() && isLoad(program[next]))) {
+                continue;
+            }
+            uint32_t target = finalTarget(load.symbol);
+            if (target != load.symbol) {
+                load.symbol = target;
+                ++stats.threaded_jumps;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool removeUnreachable() {
+        std::vector<int> references(symbols.size(), 0);
+        for (const Instruction& in : program) {
+            if (in.kind == Instruction::Kind::SYMBOL) ++references[in.symbol];
+        }
+
+        size_t before = program.size();
+        std::vector<Instruction> kept;
+        kept.reserve(program.size());
+        bool reachable = true;
+        for (const Instruction& in : program) {
+            if (in.kind == Instruction::Kind::LABEL) {
+                if (every_label_live || references[in.symbol] > 0) reachable = true;
+                kept.push_back(in);
+                continue;
+            }
+            if (in.kind == Instruction::Kind::LOCATION) {
+                kept.push_back(in);
+                continue;
+            }
+            if (!reachable) {
+                if (in.kind == Instruction::Kind::SYMBOL) --references[in.symbol];
+                continue;
+            }
+            kept.push_back(in);
+            if (isUnconditionalJump(in)) reachable = false;
+        }
+        program.swap(kept);
+        stats.unreachable += before - program.size();
+        return program.size() != before;
+    }
+
+    bool removeRedundantLoads() {
+        // what A is known to hold: a constant value or a (non-predefined) symbol id
+        enum class Known { NOTHING, VALUE, SYMBOL };
+        Known known = Known::NOTHING;
+        uint32_t known_value = 0;
+
+        size_t before = program.size();
+        std::vector<Instruction> kept;
+        kept.reserve(program.size());
+        for (const Instruction& in : program) {
+            switch (in.kind) {
+                case Instruction::Kind::LABEL:
+                    known = Known::NOTHING; // control may arrive from anywhere
+                    break;
+                case Instruction::Kind::CONSTANT:
+                case Instruction::Kind::SYMBOL: {
+                    Known loads = Known::VALUE;
+                    uint32_t value = in.word;
+                    if (in.kind == Instruction::Kind::SYMBOL) {
+                        if (symbols.isDefined(in.symbol)) {
+                            value = symbols.getAddress(in.symbol) & 0x7FFF;
+                        } else {
+                            loads = Known::SYMBOL;
+                            value = in.symbol;
+                        }
+                    }
+                    if (known == loads && known_value == value) continue;
+                    known = loads;
+                    known_value = value;
+                    break;
+                }
+                case Instruction::Kind::COMPUTE:
+                    if ((in.word & DEST_A) || isUnconditionalJump(in)) known = Known::NOTHING;
+                    break;
+                case Instruction::Kind::LOCATION:
+                    break;
+            }
+            kept.push_back(in);
+        }
+        program.swap(kept);
+        stats.redundant_loads += before - program.size();
+        return program.size() != before;
+    }
+};
+
+} // namespace
+
+OptimizerStats optimize(std::vector<Instruction>& program, const SymbolTable& symbols, bool every_label_live) {
+    Pass pass(program, symbols, every_label_live);
+    bool changed = true;
+    while (changed) {
+        pass.findLabels();
+        changed = pass.threadJumps();
+        changed |= pass.removeUnreachable();
+        changed |= pass.removeRedundantLoads();
+    }
+    return pass.stats;
+}
+
+} // namespace assembler
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "Instruction.h"
+#include "SymbolTable.h"
+
+namespace assembler {
+
+struct OptimizerStats {
+    size_t redundant_loads = 0;   // @X removed because A already held X
+    size_t threaded_jumps = 0;    // jumps retargeted past a @L / 0;JMP trampoline
+    size_t unreachable = 0;       // instructions removed after an unconditional jump
+};
+
+// rewrites a parsed program before encoding; label addresses are assigned
+// afterwards, so removed instructions simply move later labels down.
+//   - redundant A-loads: drops @X when A is known to hold X already
+//   - jump threading: @L; 0;JMP where L starts with @L2; 0;JMP becomes @L2; 0;JMP
+//   - unreachable code: drops instructions between an unconditional jump and
+//     the next label that is referenced
+// every_label_live treats each label as referenced from elsewhere, as needed
+// when the program is a relocatable object.
+OptimizerStats optimize(std::vector<Instruction>& program, const SymbolTable& symbols,
+                        bool every_label_live = false);
+
+} // namespace assembler
@@ -0,0 +1,107 @@
+#include "Parser.h"
+
+namespace assembler {
+
+Parser::Parser(std::string_view source) : source(source) {
+    current_instruction.reserve(64);
+}
+
+void Parser::reset() {
+    pos = 0;
+    line_number = 0;
+    location = {};
+    location_count = 0;
+    current_instruction.clear();
+}
+
+bool Parser::advance() {
+    current_instruction.clear();
+    while (pos < source.size()) {
+        size_t end = source.find('\n', pos);
+        if (end == std::string_view::npos) end = source.size();
+        std::string_view line = source.substr(pos, end - pos);
+        pos = end + 1;
+        ++line_number;
+
+        // remove comments
+        auto comment_pos = line.find("//");
+        if (comment_pos != std::string_view::npos) {
+            noteLocation(line.substr(comment_pos + 2));
+            line = line.substr(0, comment_pos);
+        }
+        // remove whitespace
+        for (char c : line) {
+            if (c != ' ' && c != '\t' && c != '\r' && c != '\v' && c != '\f') {
+                current_instruction.push_back(c);
+            }
+        }
+
+        if (!current_instruction.empty()) {
+            return true; // found a valid instruction
+        }
+    }
+    return false;
+}
+
+void Parser::noteLocation(std::string_view comment) {
+    // a single word ending in :<digits>
+    size_t start = comment.find_first_not_of(" \t");
+    size_t end = comment.find_last_not_of(" \t\r");
+    if (start == std::string_view::npos) return;
+    comment = comment.substr(start, end - start + 1);
+
+    size_t colon = comment.rfind(':');
+    if (colon == std::string_view::npos || colon == 0 || colon + 1 == comment.size()) return;
+    if (comment.find_first_of(" \t") != std::string_view::npos) return;
+    for (size_t i = colon + 1; i < comment.size(); ++i) {
+        if (comment[i] < '0' || comment[i] > '9') return;
+    }
+    location = comment;
+    ++location_count;
+}
+
+CommandType Parser::commandType() const {
+    if (current_instruction[0] == '@') return CommandType::A_COMMAND;
+    if (current_instruction[0] == '(') return CommandType::L_COMMAND;
+    return CommandType::C_COMMAND;
+}
+
+std::string_view Parser::symbol() const {
+    std::string_view instruction = current_instruction;
+    if (instruction[0] == '@') {
+        return instruction.substr(1);
+    }
+    if (instruction[0] == '(') {
+        return instruction.substr(1, instruction.length() - 2);
+    }
+    return {};
+}
+
+std::string_view Parser::dest() const {
+    std::string_view instruction = current_instruction;
+    auto pos = instruction.find('=');
+    if (pos != std::string_view::npos) {
+        return instruction.substr(0, pos);
+    }
+    return {};
+}
+
+std::string_view Parser::comp() const {
+    std::string_view instruction = current_instruction;
+    auto eq_pos = instruction.find('=');
+    auto sc_pos = instruction.find(';');
+    size_t start = (eq_pos == std::string_view::npos) ? 0 : eq_pos + 1;
+    size_t end = (sc_pos == std::string_view::npos) ? instruction.length() : sc_pos;
+    return instruction.substr(start, end - start);
+}
+
+std::string_view Parser::jump() const {
+    std::string_view instruction = current_instruction;
+    auto pos = instruction.find(';');
+    if (pos != std::string_view::npos) {
+        return instruction.substr(pos + 1);
+    }
+    return {};
+}
+
+} // namespace assembler
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace assembler {
+
+enum class CommandType { A_COMMAND, C_COMMAND, L_COMMAND };
+
+// reads Hack assembly one instruction at a time from an in-memory source buffer
+class Parser {
+    std::string_view source;
+    size_t pos = 0;
+
+    void noteLocation(std::string_view comment);
+
+public:
+    // current instruction with comments and all whitespace removed; the
+    // symbol/dest/comp/jump views point into it until the next advance()
+    std::string current_instruction;
+    unsigned int line_number = 0;
+
+    // last "// file:line" comment seen, as written by the VM translator with -g;
+    // location_count changes every time a new one is read
+    std::string_view location;
+    unsigned int location_count = 0;
+
+    explicit Parser(std::string_view source);
+
+    // rewinds to the start of the source.
+    void reset();
+
+    // reads the next command, skipping whitespace/comments.
+    // returns true if a command was found, false at the end of the source.
+    bool advance();
+
+    CommandType commandType() const;
+    std::string_view symbol() const;
+    std::string_view dest() const; // empty if there is no dest field
+    std::string_view comp() const;
+    std::string_view jump() const; // empty if there is no jump field
+};
+
+} // namespace assembler
@@ -0,0 +1,146 @@
+#include "RomImage.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <filesystem>
+
+namespace assembler {
+
+namespace {
+
+// the 8 ASCII binary digits of every byte value
+constexpr auto byte_digits = [] {
+    std::array<std::array<char, 8>, 256> table{};
+    for (size_t b = 0; b < 256; ++b) {
+        for (size_t bit = 0; bit < 8; ++bit) {
+            table[b][bit] = (b & (0x80 >> bit)) ? '1' : '0';
+        }
+    }
+    return table;
+}();
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("[Error] Unable to open ROM image: " + path);
+    }
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+} // namespace
+
+bool parseRomFormat(std::string_view name, RomFormat& format) {
+    if (name == "ascii") format = RomFormat::ASCII;
+    else if (name == "bin") format = RomFormat::BIN;
+    else if (name == "hex") format = RomFormat::HEX;
+    else return false;
+    return true;
+}
+
+const char* romExtension(RomFormat format) {
+    switch (format) {
+        case RomFormat::BIN: return ".bin";
+        case RomFormat::HEX: return ".hex";
+        case RomFormat::ASCII:
+        default:             return ".hack";
+    }
+}
+
+void writeRom(const std::vector<uint16_t>& words, RomFormat format, std::ostream& out) {
+    std::string buffer;
+    char* p = nullptr;
+    switch (format) {
+        case RomFormat::ASCII:
+            // two table lookups per word
+            buffer.assign(words.size() * 17, '\n');
+            p = buffer.data();
+            for (uint16_t word : words) {
+                std::memcpy(p, byte_digits[word >> 8].data(), 8);
+                std::memcpy(p + 8, byte_digits[word & 0xFF].data(), 8);
+                p += 17;
+            }
+            break;
+        case RomFormat::BIN:
+            buffer.resize(words.size() * 2);
+            p = buffer.data();
+            for (uint16_t word : words) {
+                *p++ = static_cast<char>(word & 0xFF);
+                *p++ = static_cast<char>(word >> 8);
+            }
+            break;
+        case RomFormat::HEX:
+            buffer.assign(words.size() * 5, '\n');
+            p = buffer.data();
+            for (uint16_t word : words) {
+                p[0] = hex_digits[(word >> 12) & 0xF];
+                p[1] = hex_digits[(word >> 8) & 0xF];
+                p[2] = hex_digits[(word >> 4) & 0xF];
+                p[3] = hex_digits[word & 0xF];
+                p += 5;
+            }
+            break;
+    }
+    out.write(buffer.data(), buffer.size());
+}
+
+std::vector<uint16_t> readRom(const std::string& path) {
+    std::string data = readFile(path);
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::vector<uint16_t> words;
+
+    if (extension == ".bin") {
+        if (data.size() % 2 != 0) {
+            throw std::runtime_error("[Error] " + path + ": odd number of bytes in binary ROM image");
+        }
+        words.resize(data.size() / 2);
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        for (size_t i = 0; i < words.size(); ++i) {
+            words[i] = static_cast<uint16_t>(bytes[2 * i] | (bytes[2 * i + 1] << 8));
+        }
+        return words;
+    }
+
+    // text formats: one word per line, blank lines and // comments skipped
+    const bool hex = (extension == ".hex");
+    words.reserve(data.size() / (hex ? 5 : 17));
+    std::istringstream lines(data);
+    std::string line;
+    unsigned int line_number = 0;
+    while (std::getline(lines, line)) {
+        ++line_number;
+        auto comment = line.find("//");
+        if (comment != std::string::npos) line.erase(comment);
+        unsigned int word = 0, digits = 0;
+        for (char c : line) {
+            if (c == ' ' || c == '\t' || c == '\r') continue;
+            int value = hex ? hexValue(c) : (c == '0' || c == '1' ? c - '0' : -1);
+            if (value < 0) {
+                throw std::runtime_error("[Error] " + path + ": invalid character on line " + std::to_string(line_number));
+            }
+            word = (word << (hex ? 4 : 1)) | value;
+            ++digits;
+        }
+        if (digits == 0) continue;
+        if (digits != (hex ? 4u : 16u)) {
+            throw std::runtime_error("[Error] " + path + ": malformed word on line " + std::to_string(line_number));
+        }
+        words.push_back(static_cast<uint16_t>(word));
+    }
+    return words;
+}
+
+} // namespace assembler
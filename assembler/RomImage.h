@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+namespace assembler {
+
+// on-disk formats of a ROM image
+enum class RomFormat {
+    ASCII, // .hack: one line of 16 '0'/'1' characters per word
+    BIN,   // .bin: raw 16-bit words, little-endian
+    HEX    // .hex: one 4-digit hex word per line, for Verilog $readmemh
+};
+
+// parses "ascii", "bin" or "hex"; returns false for anything else
+bool parseRomFormat(std::string_view name, RomFormat& format);
+
+// ".hack", ".bin" or ".hex"
+const char* romExtension(RomFormat format);
+
+// formats the whole image into one buffer and writes it with a single call
+void writeRom(const std::vector<uint16_t>& words, RomFormat format, std::ostream& out);
+
+// writes machine code words as .hack text, one 16-bit binary line per word
+inline void writeHack(const std::vector<uint16_t>& words, std::ostream& hack_out) {
+    writeRom(words, RomFormat::ASCII, hack_out);
+}
+
+// loads a ROM image, choosing the format by extension (.bin, .hex, else ascii)
+std::vector<uint16_t> readRom(const std::string& path);
+
+} // namespace assembler
@@ -0,0 +1,80 @@
+#include "SymbolFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace assembler {
+
+const SymbolFile::Symbol* SymbolFile::label(unsigned int address) const {
+    auto it = std::upper_bound(labels.begin(), labels.end(), address,
+                               [](unsigned int a, const Symbol& s) { return a < s.address; });
+    return (it == labels.begin()) ? nullptr : &*(it - 1);
+}
+
+const SymbolFile::Range* SymbolFile::line(unsigned int address) const {
+    auto it = std::upper_bound(lines.begin(), lines.end(), address,
+                               [](unsigned int a, const Range& r) { return a < r.begin; });
+    if (it == lines.begin() || address >= (it - 1)->end) return nullptr;
+    return &*(it - 1);
+}
+
+void SymbolFile::write(std::ostream& out) const {
+    out << "HSYM 1\n";
+    out << "labels " << labels.size() << "\n";
+    for (const auto& symbol : labels) {
+        out << symbol.address << " " << symbol.name << "\n";
+    }
+    out << "variables " << variables.size() << "\n";
+    for (const auto& symbol : variables) {
+        out << symbol.address << " " << symbol.name << "\n";
+    }
+    out << "lines " << lines.size() << "\n";
+    for (const auto& range : lines) {
+        out << range.begin << " " << range.end << " " << range.location << "\n";
+    }
+}
+
+static void expect(std::istream& in, const std::string& keyword) {
+    std::string word;
+    if (!(in >> word) || word != keyword) {
+        throw std::runtime_error("[Error] malformed symbol file: expected '" + keyword + "'");
+    }
+}
+
+SymbolFile SymbolFile::read(std::istream& in) {
+    SymbolFile sym;
+    unsigned int version = 0, count = 0;
+
+    expect(in, "HSYM");
+    if (!(in >> version) || version != 1) {
+        throw std::runtime_error("[Error] unsupported symbol file version");
+    }
+
+    expect(in, "labels");
+    in >> count;
+    sym.labels.resize(count);
+    for (auto& symbol : sym.labels) {
+        in >> symbol.address >> symbol.name;
+    }
+
+    expect(in, "variables");
+    in >> count;
+    sym.variables.resize(count);
+    for (auto& symbol : sym.variables) {
+        in >> symbol.address >> symbol.name;
+    }
+
+    expect(in, "lines");
+    in >> count;
+    sym.lines.resize(count);
+    for (auto& range : sym.lines) {
+        in >> range.begin >> range.end >> range.location;
+    }
+
+    if (!in) {
+        throw std::runtime_error("[Error] malformed symbol file: unexpected end of file");
+    }
+    return sym;
+}
+
+} // namespace assembler
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+namespace assembler {
+
+// symbol and source map of an assembled program (.sym), written next to the
+// ROM image so emulators and profilers can name program counters and RAM
+// addresses without re-parsing the assembly.
+struct SymbolFile {
+    struct Symbol {
+        unsigned int address;
+        std::string name;
+    };
+
+    // ROM addresses [begin, end) were assembled from the code after a
+    // "// file:line" comment, e.g. Main.jack:12 or Math.vm:40
+    struct Range {
+        unsigned int begin;
+        unsigned int end;
+        std::string location;
+    };
+
+    std::vector<Symbol> labels;    // ROM addresses, sorted
+    std::vector<Symbol> variables; // RAM addresses, sorted
+    std::vector<Range> lines;      // sorted, non-overlapping
+
+    // the last label at or before address, or nullptr
+    const Symbol* label(unsigned int address) const;
+    // the source range holding address, or nullptr
+    const Range* line(unsigned int address) const;
+
+    // text format:
+    //   HSYM 1
+    //   labels <n>, then per label: <address> <name>
+    //   variables <n>, then per variable: <address> <name>
+    //   lines <n>, then per range: <begin> <end> <location>
+    void write(std::ostream& out) const;
+    static SymbolFile read(std::istream& in);
+};
+
+} // namespace assembler
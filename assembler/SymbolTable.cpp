@@ -0,0 +1,66 @@
+#include "SymbolTable.h"
+
+#include <utility>
+
+namespace assembler {
+
+SymbolTable::SymbolTable() {
+    static const std::pair<const char*, unsigned int> predefined[] = {
+        {"SP", 0}, {"LCL", 1}, {"ARG", 2}, {"THIS", 3}, {"THAT", 4},
+        {"R0", 0}, {"R1", 1}, {"R2", 2}, {"R3", 3}, {"R4", 4}, {"R5", 5},
+        {"R6", 6}, {"R7", 7}, {"R8", 8}, {"R9", 9}, {"R10", 10}, {"R11", 11},
+        {"R12", 12}, {"R13", 13}, {"R14", 14}, {"R15", 15},
+        {"SCREEN", 16384}, {"KBD", 24576}
+    };
+    for (const auto& [symbol, address] : predefined) {
+        entries[id(symbol)].address = address;
+    }
+    predefined_count = entries.size();
+}
+
+uint32_t SymbolTable::id(std::string_view symbol) {
+    auto it = ids.find(symbol);
+    if (it != ids.end()) return it->second;
+
+    uint32_t new_id = entries.size();
+    names.emplace_back(symbol);
+    ids.emplace(names.back(), new_id);
+    entries.emplace_back();
+    return new_id;
+}
+
+void SymbolTable::patch(Entry& entry, std::vector<uint16_t>& code) {
+    for (int32_t f = entry.fixups; f >= 0; f = fixups[f].next) {
+        code[fixups[f].word] = static_cast<uint16_t>(entry.address & 0x7FFF);
+    }
+    entry.fixups = -1;
+}
+
+void SymbolTable::define(uint32_t id, unsigned int address, std::vector<uint16_t>& code) {
+    Entry& entry = entries[id];
+    if (entry.address >= 0) return;
+    entry.address = address;
+    patch(entry, code);
+}
+
+uint16_t SymbolTable::reference(uint32_t id, size_t word) {
+    Entry& entry = entries[id];
+    if (entry.address >= 0) {
+        return static_cast<uint16_t>(entry.address & 0x7FFF);
+    }
+    fixups.push_back({static_cast<uint32_t>(word), entry.fixups});
+    entry.fixups = fixups.size() - 1;
+    return 0;
+}
+
+void SymbolTable::allocateVariables(std::vector<uint16_t>& code, unsigned int base) {
+    // ids are handed out on first sight, and a symbol that was never defined
+    // was first seen at its first reference: id order is first-use order
+    for (Entry& entry : entries) {
+        if (entry.address >= 0 || entry.fixups < 0) continue;
+        entry.address = base++;
+        patch(entry, code);
+    }
+}
+
+} // namespace assembler
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace assembler {
+
+// maps symbols to ROM (labels) or RAM (predefined symbols, variables) addresses.
+// symbols are interned to small ids; references to a symbol that is not yet
+// defined are chained and backpatched once its address is known.
+class SymbolTable {
+    struct Entry {
+        int32_t address = -1; // -1 until defined
+        int32_t fixups = -1;  // head of the chain of words waiting for the address
+    };
+    struct Fixup {
+        uint32_t word;
+        int32_t next;
+    };
+
+    std::deque<std::string> names; // stable storage for the ids map keys
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<Entry> entries;
+    std::vector<Fixup> fixups;
+    uint32_t predefined_count = 0;
+
+    void patch(Entry& entry, std::vector<uint16_t>& code);
+
+public:
+    SymbolTable();
+
+    // id of symbol, adding it (undefined) on first sight
+    uint32_t id(std::string_view symbol);
+    const std::string& name(uint32_t id) const { return names[id]; }
+    size_t size() const { return entries.size(); }
+
+    bool isDefined(uint32_t id) const { return entries[id].address >= 0; }
+    bool isPredefined(uint32_t id) const { return id < predefined_count; }
+    unsigned int getAddress(uint32_t id) const { return entries[id].address; }
+
+    // defines a label; the first definition wins and predefined symbols cannot
+    // be redefined. patches every earlier reference to it in code.
+    void define(uint32_t id, unsigned int address, std::vector<uint16_t>& code);
+
+    // returns the address for a reference from code[word], or 0 and records
+    // the word for backpatching if the symbol is not defined yet
+    uint16_t reference(uint32_t id, size_t word);
+
+    // symbols still undefined are variables: assigns them RAM addresses from
+    // base upward in order of first use and patches their references
+    void allocateVariables(std::vector<uint16_t>& code, unsigned int base = 16);
+};
+
+} // namespace assembler
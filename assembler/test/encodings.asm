@@ -0,0 +1,49 @@
+// every comp, dest and jump field, checked against encodings.hack
+0
+1
+-1
+D
+A
+M
+!D
+!A
+!M
+-D
+-A
+-M
+D+1
+A+1
+M+1
+D-1
+A-1
+M-1
+D+A
+D+M
+D-A
+D-M
+A-D
+M-D
+D&A
+D&M
+D|A
+D|M
+M=D
+D=D
+MD=D
+A=D
+AM=D
+AD=D
+AMD=D
+0;JGT
+0;JEQ
+0;JGE
+0;JLT
+0;JNE
+0;JLE
+0;JMP
+AMD=M+1;JMP
+@0
+@32767
+@R15
+@SCREEN
+@KBD
@@ -0,0 +1,105 @@
+#!/usr/bin/env bash
+# assembler checks: the golden program in old_files still assembles to the
+# same words in every output format, every comp/dest/jump mnemonic encodes
+# as the Hack spec says, -O keeps programs' behaviour, -g maps labels and
+# variables to their addresses, and malformed input is rejected
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$WORK"
+
+cp "$REPO/assembler/old_files/asm_test_input.txt" golden.asm
+"$BIN/Assembler" golden.asm > /dev/null
+same "golden program" "$REPO/assembler/old_files/asm_test_input.hack" golden.hack
+
+cp "$REPO/assembler/test/encodings.asm" .
+"$BIN/Assembler" encodings.asm > /dev/null
+same "comp, dest and jump encodings" "$REPO/assembler/test/encodings.hack" encodings.hack
+
+# the bin and hex formats hold the same words as the .hack image
+awk '{ v = 0; for (i = 1; i <= 16; i++) v = v * 2 + substr($0, i, 1); printf "%04x\n", v }' \
+    golden.hack > golden.words
+"$BIN/Assembler" --format=hex golden.asm > /dev/null
+same "hex format" golden.words golden.hex
+"$BIN/Assembler" --format=bin golden.asm > /dev/null
+od -An -tx2 -v -w2 --endian=little golden.bin | tr -d ' ' > golden.bin.words
+same "bin format" golden.words golden.bin.words
+run golden.hack 1000000 golden.ram.hack
+for format in bin hex; do
+    run "golden.$format" 1000000 "golden.$format.ram.hack"
+    same "emulator runs the $format image like the .hack one" golden.ram.hack "golden.$format.ram.hack"
+done
+
+# -O: the optimized program is smaller and behaves the same
+mkdir -p seven
+(cd "$REPO" && hackc compiler/test_programs/Seven -o "$WORK/seven/o.hack" --keep-temps)
+cp seven/src/src.asm seven.asm
+"$BIN/Assembler" seven.asm > /dev/null
+cp seven.asm seven-O.asm
+"$BIN/Assembler" -O seven-O.asm > /dev/null
+(( $(wc -l < seven-O.hack) < $(wc -l < seven.hack) )) || fail "-O did not shrink Seven"
+run seven.hack 20000000 seven.ram.hack
+run seven-O.hack 20000000 seven-O.ram.hack
+cmp -s <(sed -n '16385,24576p' seven.ram.hack) <(sed -n '16385,24576p' seven-O.ram.hack) ||
+    fail "-O changed the screen Seven draws"
+ok "-O draws Seven's screen in $(wc -l < seven-O.hack) instead of $(wc -l < seven.hack) words"
+
+# Features only fits the ROM once optimized (hackc's -O too, or it rejects the
+# image; the src.asm it keeps is the unoptimized code either way)
+mkdir -p features
+(cd "$REPO" && hackc compiler/test/Features -o "$WORK/features/o.hack" --keep-temps -g -O)
+cp features/src/src.asm features-O.asm
+"$BIN/Assembler" -O features-O.asm > /dev/null
+run features-O.hack 20000000 features-O.ram.hack
+expected="$REPO/compiler/test/Features/expected.txt"
+ram features-O.ram.hack 8000 "$(wc -l < "$expected")" > features-O.txt
+same "-O keeps the Features results" "$expected" features-O.txt
+
+# -g: the labels and variables in the map are where counting the source says
+cp features/src/src.asm features.asm
+"$BIN/Assembler" -g features.asm > /dev/null
+awk '
+    { sub(/\/\/.*/, ""); gsub(/[ \t\r]/, "") }
+    $0 == "" { next }
+    /^\(/ { label[substr($0, 2, length($0) - 2)] = 1; print pc, substr($0, 2, length($0) - 2); next }
+    { pc++ }
+    /^@/ { s = substr($0, 2); if (s !~ /^[0-9]/ && !(s in seen)) { seen[s] = 1; order[n++] = s } }
+    END {
+        split("SP LCL ARG THIS THAT SCREEN KBD", names, " ")
+        for (i in names) predefined[names[i]] = 1
+        for (r = 0; r < 16; r++) predefined["R" r] = 1
+        for (i = 0; i < n; i++)
+            if (!(order[i] in predefined) && !(order[i] in label)) print 16 + v++, order[i] > "/dev/stderr"
+    }' features.asm > labels.want 2> variables.want
+awk '/^labels /{ part = "labels"; next } /^variables /{ part = "variables"; next } /^lines /{ part = ""; next }
+     part != "" { print > (part ".got") }' features.sym
+same "-g label addresses" labels.want labels.got
+same "-g variable addresses" variables.want variables.got
+
+# with -O the map describes the optimized code: every address and line range
+# still lies inside the image, and the ranges follow each other
+cp features.asm features-Og.asm
+"$BIN/Assembler" -O -g features-Og.asm > /dev/null
+awk -v size="$(wc -l < features-Og.hack)" '
+    /^labels /{ part = "labels"; next } /^variables /{ part = ""; next } /^lines /{ part = "lines"; next }
+    part == "labels" && $1 > size { print "label past the end: " $0; bad = 1 }
+    part == "lines" && ($1 >= $2 || $1 < end || $2 > size) { print "bad line range: " $0; bad = 1 }
+    part == "lines" { end = $2; ranges++ }
+    END { if (!ranges) { print "no line ranges"; bad = 1 } exit bad }' features-Og.sym > features-Og.log ||
+    fail "-O -g map: $(head -1 features-Og.log)"
+ok "-O -g map lies inside the image"
+
+# rejects <what> <source line>: assembling the line fails with an error
+rejects() {
+    printf '%s\n' "$2" > bad.asm
+    if "$BIN/Assembler" bad.asm > bad.log 2>&1; then
+        fail "$1 accepted: $2"
+    fi
+    grep -q '^\[Error\]' bad.log || fail "$1: no error message for $2"
+    ok "$1 rejected: $2"
+}
+
+rejects "malformed constant" "@123abc"
+rejects "malformed constant" "@12.5"
+rejects "constant out of range" "@32768"
+rejects "unknown comp" "D=X+1"
+rejects "unknown comp" "M=D+2"
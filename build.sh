@@ -1,14 +1,14 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
-# Configuration
+# Configuration (each setting can be overridden from the environment)
 JACK_SOURCE=${1:-.}
-BUILD_DIR="build"
+BUILD_DIR="${BUILD_DIR:-build}"
 SRC_DIR="$BUILD_DIR/src"
-COMPILER="./j"
-VM_TRANSLATOR="./VM/VirtualMachine"
-ASSEMBLER="./assembler/Assembler"
-OS_DIR="OS"
+COMPILER="${COMPILER:-./j}"
+VM_TRANSLATOR="${VM_TRANSLATOR:-./VM/VirtualMachine}"
+ASSEMBLER="${ASSEMBLER:-./assembler/Assembler}"
+OS_DIR="${OS_DIR:-OS}"
 OUT_HACK="$BUILD_DIR/o.hack"
 
 clean() {
@@ -22,7 +22,7 @@ if [[ "${JACK_SOURCE}" == "clean" ]]; then
 fi
 
 if [[ ! -e "$JACK_SOURCE" ]]; then
-    echo "Error: source '$JACK_SOURCE' not found" >&2
+    echo "[Error] source '$JACK_SOURCE' not found" >&2
     exit 1
 fi
 
@@ -49,9 +49,9 @@ else
 fi
 
 # Ensure tools exist
-if [[ ! -x "$COMPILER" ]]; then echo "Error: compiler not found/executable ($COMPILER)" >&2; exit 1; fi
-if [[ ! -x "$VM_TRANSLATOR" ]]; then echo "Error: VM translator not found/executable ($VM_TRANSLATOR)" >&2; exit 1; fi
-if [[ ! -x "$ASSEMBLER" ]]; then echo "Error: assembler not found/executable ($ASSEMBLER)" >&2; exit 1; fi
+if [[ ! -x "$COMPILER" ]]; then echo "[Error] compiler not found/executable ($COMPILER)" >&2; exit 1; fi
+if [[ ! -x "$VM_TRANSLATOR" ]]; then echo "[Error] VM translator not found/executable ($VM_TRANSLATOR)" >&2; exit 1; fi
+if [[ ! -x "$ASSEMBLER" ]]; then echo "[Error] assembler not found/executable ($ASSEMBLER)" >&2; exit 1; fi
 
 echo "Compiling Jack sources in $SRC_DIR -> .vm"
 "$COMPILER" "$SRC_DIR"
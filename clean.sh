@@ -40,7 +40,7 @@ done
 # repo-root guard: ensure we're in Hack project root
 # (adjust this if your repo has a different sentinel file)
 if [[ ! -f "compiler/JackCompiler.cpp" ]]; then
-  echo "[error] must run from Hack project root (compiler/JackCompiler.cpp not found)." >&2
+  echo "[Error] must run from Hack project root (compiler/JackCompiler.cpp not found)." >&2
   exit 2
 fi
 
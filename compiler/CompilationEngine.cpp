@@ -4,14 +4,15 @@
 #include <stdexcept>
 #include <cstdlib>
 
-CompilationEngine::CompilationEngine(JackTokenizer& jack_tokenizer, bool emit_xml) :
+CompilationEngine::CompilationEngine(JackTokenizer& jack_tokenizer, bool emit_xml,
+                                     std::vector<vm::Command>* vm_commands) :
+    emit_xml_flag{emit_xml},
     tokenizer(jack_tokenizer), 
     class_symbol_table{},
     subroutine_symbol_table{},
-    vmwriter(jack_tokenizer.path),
-    emit_xml_flag{emit_xml},
-    indent_level{0},
-    class_name{} {
+    class_name{},
+    vmwriter(jack_tokenizer.path, vm_commands),
+    indent_level{0} {
 
     if (emit_xml) {
         std::filesystem::path xml_file_path = jack_tokenizer.path;
@@ -19,7 +20,7 @@ CompilationEngine::CompilationEngine(JackTokenizer& jack_tokenizer, bool emit_xm
         // open output file
         xml_file.open(xml_file_path);
         if (!xml_file.is_open()) {
-            std::cerr << "[error] cannot create XML file: " << xml_file_path << " \n";
+            std::cerr << "[Error] cannot create XML file: " << xml_file_path << " \n";
             std::exit(1);
         }
     }
@@ -112,7 +113,7 @@ std::string CompilationEngine::kindToCategory(Kind k) {
         case Kind::k_FIELD: return "field";
         case Kind::k_ARG: return "arg";
         case Kind::k_VAR: return "var";
-        default: throw std::runtime_error("[error] no match for k in kindToCategory()."); // not in symbol table
+        default: throw std::runtime_error("[Error] no match for k in kindToCategory()."); // not in symbol table
     }
 }
 
@@ -122,7 +123,7 @@ std::string CompilationEngine::kindToSegment(Kind k) {
         case Kind::k_FIELD: return "this"; // fields 
         case Kind::k_ARG: return "argument";
         case Kind::k_VAR: return "local";
-        default: throw std::runtime_error("[error] no match for k in kindToSegment()."); 
+        default: throw std::runtime_error("[Error] no match for k in kindToSegment()."); 
     }
 }
 
@@ -171,7 +172,7 @@ void CompilationEngine::pushVar(const std::string& name) {
     else {
         k = class_symbol_table.kindOf(name);
         if (k == Kind::k_NONE) {
-            throw std::runtime_error("[error] Unknown variable: " + name + " at line " + std::to_string(tokenizer.line_number) + ".\n > " + tokenizer.current_line + ".\n");
+            throw std::runtime_error("[Error] Unknown variable: " + name + " at line " + std::to_string(tokenizer.line_number) + ".\n > " + tokenizer.current_line + ".\n");
         }
         index = class_symbol_table.indexOf(name);
     }
@@ -189,7 +190,7 @@ void CompilationEngine::popVar(const std::string& name) {
     else {
         k = class_symbol_table.kindOf(name);
         if (k == Kind::k_NONE) {
-            throw std::runtime_error("[error] Unknown variable: " + name + " at line " + std::to_string(tokenizer.line_number) + ".\n > " + tokenizer.current_line + ".\n");
+            throw std::runtime_error("[Error] Unknown variable: " + name + " at line " + std::to_string(tokenizer.line_number) + ".\n > " + tokenizer.current_line + ".\n");
         }
         index = class_symbol_table.indexOf(name);
     }
@@ -197,10 +198,6 @@ void CompilationEngine::popVar(const std::string& name) {
     vmwriter.writePop(kindToSegment(k), index);
 }
 
-void CompilationEngine::codeWrite(const std::string& exp) {
-    
-}
-
 void CompilationEngine::compileClass() {
     // clear symbol table
     class_symbol_table.reset();
@@ -487,6 +484,7 @@ void CompilationEngine::compileSubroutineBody() {
         throw std::runtime_error("Expected '{' at start of subroutineBody at line " + std::to_string(tokenizer.line_number) + ".\n > " + tokenizer.current_line + ".\n");
 
     emitToken("symbol", "{");
+    vmwriter.setSourceLine(tokenizer.line_number);
     tokenizer.advance();
 
     // varDec*
@@ -595,6 +593,7 @@ void CompilationEngine::compileStatements() {
     emitOpen("statements");
     // letStatement|ifStatement|whileStatement|doStatement|returnStatement
     while (tokenizer.tokenType() == Type::t_KEYWORD) {
+        vmwriter.setSourceLine(tokenizer.line_number);
         switch (tokenizer.keyWord()) {
             case KeyWord::kw_LET:
                 compileLet();
@@ -615,6 +614,11 @@ void CompilationEngine::compileStatements() {
             case KeyWord::kw_RETURN:
                 compileReturn();
                 break;
+
+            default:
+                // not a statement: ends the list, the caller expects '}'
+                emitClose("statements");
+                return;
         }
     }
     emitClose("statements");
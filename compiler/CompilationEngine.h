@@ -4,6 +4,7 @@
 #include <string>
 #include <cstddef>
 #include <filesystem>
+#include <vector>
 
 #include "TokenUtils.h"
 #include "SymbolTable.h"
@@ -11,7 +12,9 @@
 
 class CompilationEngine {
 public:
-    CompilationEngine(JackTokenizer& jack_tokenizer, bool emit_xml = false);
+    // vm_commands: collect the VM code in memory instead of writing Xxx.vm
+    CompilationEngine(JackTokenizer& jack_tokenizer, bool emit_xml = false,
+                      std::vector<vm::Command>* vm_commands = nullptr);
     ~CompilationEngine();
 
     // entry point
@@ -60,7 +63,6 @@ private:
     void writeUnaryOp(char op);
     void pushVar(const std::string& name);
     void popVar(const std::string& name);
-    void codeWrite(const std::string& exp);
 
     // compilation routines 
     void compileClass();
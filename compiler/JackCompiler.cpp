@@ -19,7 +19,7 @@ int main(int argc, char* argv[]) {
     std::filesystem::path source_path = argv[1];
 
     if (!std::filesystem::exists(source_path)) {
-        std::cerr << "[error] Path does not exist: " << source_path.string() << "\n";
+        std::cerr << "[Error] Path does not exist: " << source_path.string() << "\n";
         return 1;
     }
 
@@ -35,13 +35,13 @@ int main(int argc, char* argv[]) {
         }
 
         if (jack_files.empty()) {
-            std::cerr << "[error] No .jack files found in directory: " << source_path.string() << "\n";
+            std::cerr << "[Error] No .jack files found in directory: " << source_path.string() << "\n";
             return 1;
         }
     } else {
         // must be a single .jack file
         if (source_path.extension() != ".jack") {
-            std::cerr << "[error] Expected a .jack file or a directory, got: " << source_path.string() << "\n";
+            std::cerr << "[Error] Expected a .jack file or a directory, got: " << source_path.string() << "\n";
             return 1;
         }
         jack_files.push_back(source_path);
@@ -65,7 +65,7 @@ int main(int argc, char* argv[]) {
             std::cout << "Compilation Successful. Output written to: " << output_path.string() << "\n";
         } 
         catch (const std::exception& e) {
-            std::cerr << "[error] While compiling " << jack_file.string() << ":\n"
+            std::cerr << "[Error] While compiling " << jack_file.string() << ":\n"
                       << "  " << e.what() << "\n";
             return 1;
         }
@@ -39,7 +39,7 @@ JackTokenizer::JackTokenizer(std::filesystem::path file, bool emit_xml) :
     // open input file
     jack_file.open(file);
     if (!jack_file.is_open()) {
-        std::cerr << "[error] unable to open input file: " << file.string() << ".\n";
+        std::cerr << "[Error] unable to open input file: " << file.string() << ".\n";
         exit(1);
     }
 
@@ -50,7 +50,7 @@ JackTokenizer::JackTokenizer(std::filesystem::path file, bool emit_xml) :
         // open output file
         t_xml_file.open(t_xml_file_path);
         if (!t_xml_file.is_open()) {
-            std::cerr << "[error] cannot create XML file: " << t_xml_file_path.string() << " \n";
+            std::cerr << "[Error] cannot create XML file: " << t_xml_file_path.string() << " \n";
             std::exit(1);
         }
         // opening format
@@ -159,7 +159,7 @@ void JackTokenizer::processCurrentToken(std::string token) {
         current_type = Type::t_STRING_CONST;
     else if (is_identifier(token))
         current_type = Type::t_IDENTIFIER;
-    else throw std::runtime_error("[error] token " + token + " has no valid type.\n");
+    else throw std::runtime_error("[Error] token " + token + " has no valid type.\n");
 }
 
 void JackTokenizer::commentAnalyzer() {
@@ -276,18 +276,18 @@ Type JackTokenizer::tokenType() { return current_type; }
 KeyWord JackTokenizer::keyWord() { 
     if (current_type == Type::t_KEYWORD) 
         return current_keyword;
-    else throw std::invalid_argument("[error] keyWord() method was called on non-keyword type.\n");
+    else throw std::invalid_argument("[Error] keyWord() method was called on non-keyword type.\n");
 }
 
 char JackTokenizer::symbol() { 
     if (current_type == Type::t_SYMBOL) 
         return current_token[0];
-    else throw std::invalid_argument("[error] symbol() method was called on non-symbol type.\n");
+    else throw std::invalid_argument("[Error] symbol() method was called on non-symbol type.\n");
 }
 std::string JackTokenizer::identifier() {
     if (current_type == Type::t_IDENTIFIER)
         return current_token;
-    else throw std::invalid_argument("[error] identifer() method was called on non-identifier type.\n");
+    else throw std::invalid_argument("[Error] identifer() method was called on non-identifier type.\n");
 }
 
 uint16_t JackTokenizer::parse_uint15(const std::string current_token) {
@@ -296,18 +296,18 @@ uint16_t JackTokenizer::parse_uint15(const std::string current_token) {
     if ((value < LIMIT) || (value >= -LIMIT))
         return static_cast<uint16_t>(value);    
     else {    
-        throw std::out_of_range("[error] Integer " + current_token + " at line " + std::to_string(line_number) + " exceeds 2^15 hardware limit.\n > " + current_line + '\n');
+        throw std::out_of_range("[Error] Integer " + current_token + " at line " + std::to_string(line_number) + " exceeds 2^15 hardware limit.\n > " + current_line + '\n');
     }
 }
 
 int JackTokenizer::intVal() {
     if (current_type == Type::t_INT_CONST)
         return parse_uint15(current_token);
-    else throw std::invalid_argument("[error] intVal() method was called on non-int type.\n");
+    else throw std::invalid_argument("[Error] intVal() method was called on non-int type.\n");
 }
 
 std::string JackTokenizer::stringVal() {
     if (current_type == Type::t_STRING_CONST)
         return current_token.substr(1, current_token.size()-2); // removes " "
-    else throw std::invalid_argument("[error] stringVal() method was called on non-string type.\n");
+    else throw std::invalid_argument("[Error] stringVal() method was called on non-string type.\n");
 }
\ No newline at end of file
@@ -39,7 +39,7 @@ int SymbolTable::varCount(Kind kind){
         case Kind::k_VAR: return var_index; break;
         default: break;
     }
-    throw std::runtime_error("[error] invalid kind for method varCount()\n");
+    throw std::runtime_error("[Error] invalid kind for method varCount()\n");
 }
 
 Kind SymbolTable::kindOf(std::string name){
@@ -53,12 +53,12 @@ std::string SymbolTable::typeOf(std::string name){
     if (auto it = symbol_table.find(name); it != symbol_table.end()) {
         return it->second.type;
     }
-    else throw std::runtime_error("[error] symbol has no type: " + name + '\n');
+    else throw std::runtime_error("[Error] symbol has no type: " + name + '\n');
 }
 
 int SymbolTable::indexOf(std::string name){
     if (auto it = symbol_table.find(name); it != symbol_table.end()) {
         return it->second.index;
     }
-    else throw std::runtime_error("[error] symbol has no index: " + name + '\n');
+    else throw std::runtime_error("[Error] symbol has no index: " + name + '\n');
 }
\ No newline at end of file
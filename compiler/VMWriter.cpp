@@ -4,13 +4,16 @@
 // // i would like to change the VM types into enums 
 // // instead of strings but VM is written to take string
 
-VMWriter::VMWriter(std::filesystem::path vm_file_path) :
+VMWriter::VMWriter(std::filesystem::path vm_file_path, std::vector<vm::Command>* commands) :
+    vm_commands{commands},
     label_count{0} {
     
+    if (vm_commands) return; // nothing to open, commands stay in memory
+
     vm_file_path.replace_extension("vm");
     vm_file.open(vm_file_path);
     if (!vm_file.is_open()) {
-        std::cerr << "[error] cannot create VM file: " << vm_file_path.string() << " \n";
+        std::cerr << "[Error] cannot create VM file: " << vm_file_path.string() << " \n";
         std::exit(1);
     }
 }
@@ -19,12 +22,20 @@ VMWriter::~VMWriter() {
         vm_file.close();
 }
 
+void VMWriter::emit(vm::Command command) {
+    command.line = source_line;
+    if (vm_commands)
+        vm_commands->push_back(std::move(command));
+    else
+        vm_file << command << '\n';
+}
+
 void VMWriter::writePush(const std::string& segment, int index) {
-    vm_file << "push " << segment << " " << index << '\n';
+    emit({vm::CommandType::C_PUSH, segment, index});
 }
 
 void VMWriter::writePop(const std::string& segment, int index) {
-    vm_file << "pop " << segment << " " << index << '\n';
+    emit({vm::CommandType::C_POP, segment, index});
 }
 
 void VMWriter::writeArithmetic(const std::string& command) {
@@ -35,11 +46,11 @@ void VMWriter::writeArithmetic(const std::string& command) {
     };
     if (arithmetic.find(command) == arithmetic.end()) 
         throw std::runtime_error("VMWriter::writeArithmetic: invalid command '" + command + "'");
-    vm_file << command << '\n';
+    emit({vm::CommandType::C_ARITHMETIC, command, 0});
 }
 
 void VMWriter::writeLabel(const std::string& label) {
-    vm_file << "label " << label << '\n';
+    emit({vm::CommandType::C_LABEL, label, 0});
 }
 
 std::string VMWriter::getLabel() {
@@ -47,23 +58,23 @@ std::string VMWriter::getLabel() {
 }
 
 void VMWriter::writeGoto(const std::string& label) {
-    vm_file << "goto " << label << '\n';
+    emit({vm::CommandType::C_GOTO, label, 0});
 }
 
 void VMWriter::writeIf(const std::string& label) {
-    vm_file << "if-goto " << label << '\n';
+    emit({vm::CommandType::C_IF, label, 0});
 }
 
 void VMWriter::writeCall(const std::string& name, int nArgs) {
-    vm_file << "call " << name << " " << nArgs << '\n';
+    emit({vm::CommandType::C_CALL, name, nArgs});
 }
 
 void VMWriter::writeFunction(const std::string& name, int nVars) {
-    vm_file << "function " << name << " " << nVars << '\n';
+    emit({vm::CommandType::C_FUNCTION, name, nVars});
 }
 
 void VMWriter::writeReturn() {
-    vm_file << "return\n";
+    emit({vm::CommandType::C_RETURN, "", 0});
 }
 
 void VMWriter::close() {
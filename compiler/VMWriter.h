@@ -8,6 +8,9 @@
 #include <unordered_set>
 #include <cstdlib>
 #include <stdexcept>
+#include <vector>
+
+#include "../VM/VMCommand.h"
 
 // // refer to TO-DO in .cpp
 // // enum class Segment {
@@ -23,13 +26,21 @@
 
 class VMWriter {
     std::ofstream vm_file;
+    std::vector<vm::Command>* vm_commands; // in-memory sink, replaces vm_file when set
     unsigned int label_count;
+    unsigned int source_line = 0;
+
+    void emit(vm::Command command);
     
 public:
-    VMWriter(std::filesystem::path vm_file_path);
+    // writes Xxx.vm next to the source, or appends to commands if given
+    VMWriter(std::filesystem::path vm_file_path, std::vector<vm::Command>* commands = nullptr);
     
     ~VMWriter();
 
+    // Jack source line recorded on the commands written from now on
+    void setSourceLine(unsigned int line) { source_line = line; }
+
     // writes a VM push command
     void writePush(const std::string& segment, int index);
 
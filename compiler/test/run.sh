@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+# compiler checks: the Features program computes what expected.txt says, and
+# the driver's compiler stage writes the same .vm files as the j tool
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$REPO"
+
+hackc compiler/test/Features -o "$WORK/features.hack" --incremental -O
+run "$WORK/features.hack" 20000000 "$WORK/features.ram.hack"
+ram "$WORK/features.ram.hack" 8000 "$(wc -l < compiler/test/Features/expected.txt)" > "$WORK/features.txt"
+same "Features computes expected.txt" compiler/test/Features/expected.txt "$WORK/features.txt"
+
+for program in compiler/test/Features compiler/test_programs/*/; do
+    name="$(basename "$program")"
+    mkdir -p "$WORK/j/$name"
+    cp "$program"/*.jack "$WORK/j/$name/"
+    "$BIN/j" "$WORK/j/$name" > /dev/null
+    mkdir -p "$WORK/keep/$name"
+    hackc "$program" -o "$WORK/keep/$name/o.hack" --no-os --keep-temps
+    for vm in "$WORK/j/$name"/*.vm; do
+        cmp -s "$vm" "$WORK/keep/$name/src/$(basename "$vm")" || fail "$name: j and hackc differ on $(basename "$vm")"
+    done
+    ok "$name: j and hackc write the same .vm"
+done
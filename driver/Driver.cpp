@@ -0,0 +1,417 @@
+// Driver.cpp
+// Builds a Jack program to Hack machine code in a single process:
+// Jack -> VM -> Hack assembly -> Hack machine code.
+// The stages are linked in as libraries and hand their output to each other
+// in memory; nothing is written besides the final .hack unless --keep-temps is set.
+// With --incremental, every class is instead assembled into its own relocatable
+// object, cached next to the output, and only stale classes are rebuilt before linking.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+#include <functional>
+
+#include "../compiler/CompilationEngine.h"
+#include "../VM/Parser.h"
+#include "../VM/CodeWriter.h"
+#include "../VM/NativeBodies.h"
+#include "../assembler/HackAssembler.h"
+#include "../assembler/ObjectFile.h"
+#include "../linker/ObjectLinker.h"
+
+namespace fs = std::filesystem;
+
+constexpr size_t ROM_SIZE = 32768;
+
+struct Options {
+    fs::path source;
+    fs::path output = "build/o.hack";
+    fs::path os_dir = "OS";
+    fs::path native_dir;
+    bool include_os = true;
+    bool keep_temps = false;
+    bool incremental = false;
+    bool optimize_code = false;
+    bool write_symbols = false;
+    assembler::RomFormat format = assembler::RomFormat::ASCII;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <source> [-o <out.hack>] [--os <dir>] [--no-os] [--keep-temps] [--incremental]\n"
+              << "             [--native <dir>] [-O] [-g] [--format=ascii|bin|hex]\n"
+              << "  where <source> is either:\n"
+              << "    - a single .jack file, or\n"
+              << "    - a directory containing one or more .jack files\n"
+              << "  -o <out.hack>   output file (default: build/o.hack)\n"
+              << "  --os <dir>      directory of OS .vm files to link (default: OS)\n"
+              << "  --no-os         do not link the OS\n"
+              << "  --keep-temps    also write the .vm and .asm stages next to the output\n"
+              << "  --incremental   cache one object per class in <out dir>/obj and link them,\n"
+              << "                  rebuilding only classes whose source changed\n"
+              << "  --native <dir>  hand-written <Class>.<function>.asm bodies that replace the\n"
+              << "                  translated code of those functions\n"
+              << "  -O              run the assembler's optimizer over the generated code\n"
+              << "  -g              also write <out>.sym mapping labels, variables and Jack/VM\n"
+              << "                  source lines to addresses (no source lines with --incremental)\n"
+              << "  --format=...    ROM image format, see the assembler (default: ascii)\n";
+}
+
+static bool parseArgs(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            opts.output = argv[++i];
+        } else if (arg == "--os" && i + 1 < argc) {
+            opts.os_dir = argv[++i];
+        } else if (arg == "--native" && i + 1 < argc) {
+            opts.native_dir = argv[++i];
+        } else if (arg == "--no-os") {
+            opts.include_os = false;
+        } else if (arg == "--keep-temps") {
+            opts.keep_temps = true;
+        } else if (arg == "--incremental") {
+            opts.incremental = true;
+        } else if (arg == "-O") {
+            opts.optimize_code = true;
+        } else if (arg == "-g") {
+            opts.write_symbols = true;
+        } else if (arg.rfind("--format=", 0) == 0) {
+            if (!assembler::parseRomFormat(arg.substr(9), opts.format)) return false;
+        } else if (!arg.empty() && arg[0] != '-' && opts.source.empty()) {
+            opts.source = arg;
+        } else {
+            return false;
+        }
+    }
+    return !opts.source.empty();
+}
+
+// wall-clock time per stage, reported at the end of the build
+class StageTimer {
+    using clock = std::chrono::steady_clock;
+    std::vector<std::pair<std::string, double>> stages;
+    clock::time_point start = clock::now();
+
+public:
+    void lap(const std::string& stage) {
+        clock::time_point now = clock::now();
+        stages.emplace_back(stage, std::chrono::duration<double, std::milli>(now - start).count());
+        start = now;
+    }
+
+    void report(std::ostream& os) const {
+        double total = 0;
+        for (const auto& [stage, ms] : stages) {
+            os << "  " << std::left << std::setw(10) << stage
+               << std::right << std::fixed << std::setprecision(2) << std::setw(9) << ms << " ms\n";
+            total += ms;
+        }
+        os << "  " << std::left << std::setw(10) << "total"
+           << std::right << std::fixed << std::setprecision(2) << std::setw(9) << total << " ms\n";
+    }
+};
+
+static std::vector<fs::path> collectFiles(const fs::path& dir, const std::string& extension) {
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == extension) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static vm::Module compileClass(const fs::path& jack_file) {
+    vm::Module module{jack_file.stem().string(), {}, jack_file.filename().string()};
+    JackTokenizer tokenizer(jack_file);
+    tokenizer.advance();
+    CompilationEngine engine(tokenizer, false, &module.commands);
+    engine.compile();
+    return module;
+}
+
+// translates and assembles VM code on its own into a relocatable object
+static assembler::ObjectFile buildObject(const vm::Module* module, bool bootstrap, bool optimize_code,
+                                        const vm::NativeBodies& natives) {
+    std::ostringstream asm_out;
+    vm::CodeWriter writer(asm_out);
+    writer.setNativeBodies(&natives);
+    if (bootstrap) writer.writeInit();
+    if (module) writer.writeModule(*module);
+    return assembler::assembleObject(asm_out.str(), optimize_code);
+}
+
+// the shared call and return routines the objects jump to, linked after them
+static assembler::ObjectFile buildRuntime(bool optimize_code) {
+    std::ostringstream asm_out;
+    vm::CodeWriter writer(asm_out);
+    writer.writeRuntime();
+    return assembler::assembleObject(asm_out.str(), optimize_code);
+}
+
+// one class of the program or the OS, with its cached object
+struct ObjectSource {
+    std::string name;
+    fs::path source;    // .jack or .vm
+    fs::path object;    // cached .hobj
+};
+
+// identifies the toolchain that builds the objects: a hash of the driver
+// executable, which has the compiler, translator and assembler linked in.
+// Its path comes from /proc/self/exe where there is one, else from argv[0];
+// failing both, the time Driver.cpp was compiled stands in.
+static std::string toolchainStamp(const char* argv0) {
+    std::error_code ec;
+    fs::path exe = fs::read_symlink("/proc/self/exe", ec);
+    if (ec) exe = argv0;
+    std::ifstream in(exe, std::ios::binary);
+    if (!in) return std::string("built ") + __DATE__ + " " + __TIME__;
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    std::ostringstream out;
+    out << "hackc " << std::hex << std::hash<std::string>{}(contents.str());
+    return out.str();
+}
+
+// a cached object is reused while the source it was built from is unchanged;
+// the stamp beside it records that source's path, modification time, the
+// toolchain and flags it was built with and the native bodies of its class
+static std::string sourceStamp(const ObjectSource& src, const std::string& build, const vm::NativeBodies& natives) {
+    return fs::absolute(src.source).string() + " " +
+           std::to_string(fs::last_write_time(src.source).time_since_epoch().count()) + " " +
+           build + natives.stamp(src.name);
+}
+
+static bool isCached(const ObjectSource& src, const std::string& build, const vm::NativeBodies& natives) {
+    std::ifstream stamp_file(fs::path(src.object).replace_extension(".stamp"));
+    std::string stamp;
+    return fs::exists(src.object) && std::getline(stamp_file, stamp) &&
+           stamp == sourceStamp(src, build, natives);
+}
+
+static int buildIncremental(const Options& opts, const std::string& toolchain, const vm::NativeBodies& natives,
+                            const std::vector<fs::path>& jack_files, StageTimer& timer) {
+    std::string build = toolchain + (opts.optimize_code ? " -O" : "");
+    fs::path cache_dir = opts.output.parent_path() / "obj";
+    fs::create_directories(cache_dir / "os");
+
+    std::vector<ObjectSource> sources;
+    std::set<std::string> program_classes;
+    for (const auto& jack_file : jack_files) {
+        std::string name = jack_file.stem().string();
+        sources.push_back({name, jack_file, cache_dir / (name + ".hobj")});
+        program_classes.insert(name);
+    }
+    if (opts.include_os) {
+        if (!fs::is_directory(opts.os_dir)) {
+            throw std::runtime_error("[Error] OS directory not found: " + opts.os_dir.string());
+        }
+        for (const auto& vm_file : collectFiles(opts.os_dir, ".vm")) {
+            std::string name = vm_file.stem().string();
+            if (program_classes.count(name)) continue;
+            sources.push_back({name, vm_file, cache_dir / "os" / (name + ".hobj")});
+        }
+    }
+    std::sort(sources.begin(), sources.end(),
+              [](const ObjectSource& a, const ObjectSource& b) { return a.name < b.name; });
+
+    linker::ObjectLinker objectLinker;
+    if (sources.size() > 1) {
+        objectLinker.addObject(buildObject(nullptr, true, opts.optimize_code, natives), "bootstrap");
+    }
+    size_t rebuilt = 0;
+    for (const auto& src : sources) {
+        if (isCached(src, build, natives)) {
+            std::ifstream in(src.object);
+            objectLinker.addObject(assembler::ObjectFile::read(in), src.object.string());
+            continue;
+        }
+        vm::Module module = (src.source.extension() == ".jack")
+                          ? compileClass(src.source)
+                          : vm::Parser(src.source.string()).parseModule(src.name);
+        assembler::ObjectFile obj = buildObject(&module, false, opts.optimize_code, natives);
+        std::ofstream out(src.object);
+        obj.write(out);
+        std::ofstream(fs::path(src.object).replace_extension(".stamp")) << sourceStamp(src, build, natives) << "\n";
+        objectLinker.addObject(std::move(obj), src.object.string());
+        ++rebuilt;
+    }
+    objectLinker.addObject(buildRuntime(opts.optimize_code), "runtime");
+    timer.lap("objects");
+
+    assembler::SymbolFile symbols;
+    std::vector<uint16_t> image = objectLinker.link(true, opts.write_symbols ? &symbols : nullptr);
+    timer.lap("link");
+
+    std::ofstream hack_file(opts.output, std::ios::binary);
+    if (!hack_file.is_open()) {
+        std::cerr << "[Error] Unable to create output file: " << opts.output.string() << "\n";
+        return 1;
+    }
+    assembler::writeRom(image, opts.format, hack_file);
+    hack_file.close();
+    if (opts.write_symbols) {
+        std::ofstream sym_file(fs::path(opts.output).replace_extension(".sym"));
+        symbols.write(sym_file);
+    }
+    timer.lap("write");
+
+    std::cout << "Build complete: " << opts.output.string() << "\n"
+              << "  rebuilt " << rebuilt << " of " << sources.size() << " objects, kept "
+              << objectLinker.sectionsKept() << " of " << objectLinker.sectionsTotal()
+              << " sections (" << image.size() << " words)\n";
+    timer.report(std::cout);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<fs::path> jack_files;
+    if (fs::is_directory(opts.source)) {
+        jack_files = collectFiles(opts.source, ".jack");
+    } else if (opts.source.extension() == ".jack" && fs::is_regular_file(opts.source)) {
+        jack_files.push_back(opts.source);
+    } else {
+        std::cerr << "[Error] Expected a .jack file or a directory, got: " << opts.source.string() << "\n";
+        return 1;
+    }
+    if (jack_files.empty()) {
+        std::cerr << "[Error] No .jack files found in directory: " << opts.source.string() << "\n";
+        return 1;
+    }
+
+    StageTimer timer;
+    if (opts.output.has_parent_path()) {
+        fs::create_directories(opts.output.parent_path());
+    }
+
+    vm::NativeBodies natives;
+    if (!opts.native_dir.empty()) {
+        try {
+            natives = vm::NativeBodies(opts.native_dir.string());
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    if (opts.incremental) {
+        try {
+            return buildIncremental(opts, toolchainStamp(argv[0]), natives, jack_files, timer);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<vm::Module> modules;
+    std::string asm_code;
+    std::vector<uint16_t> image;
+    assembler::SymbolFile symbols;
+
+    try {
+        // Jack -> VM
+        std::set<std::string> program_classes;
+        for (const auto& jack_file : jack_files) {
+            modules.push_back(compileClass(jack_file));
+            program_classes.insert(modules.back().name);
+        }
+        timer.lap("compile");
+
+        // OS classes are linked from their .vm files; a program class of the
+        // same name replaces the OS one
+        if (opts.include_os) {
+            if (!fs::is_directory(opts.os_dir)) {
+                throw std::runtime_error("[Error] OS directory not found: " + opts.os_dir.string());
+            }
+            for (const auto& vm_file : collectFiles(opts.os_dir, ".vm")) {
+                std::string name = vm_file.stem().string();
+                if (program_classes.count(name)) continue;
+                vm::Parser parser(vm_file.string());
+                modules.push_back(parser.parseModule(name));
+            }
+            timer.lap("load OS");
+        }
+
+        // same order as the VM translator gives a directory of .vm files
+        std::sort(modules.begin(), modules.end(),
+                  [](const vm::Module& a, const vm::Module& b) { return a.name < b.name; });
+
+        // VM -> ASM
+        std::ostringstream asm_out;
+        vm::CodeWriter writer(asm_out);
+        writer.setSourceLines(opts.write_symbols);
+        writer.setNativeBodies(&natives);
+        if (modules.size() > 1) {
+            writer.writeInit();
+        }
+        for (const auto& module : modules) {
+            writer.writeModule(module);
+        }
+        if (writer.needsRuntime()) {
+            writer.writeRuntime();
+        }
+        asm_code = asm_out.str();
+        timer.lap("translate");
+
+        // ASM -> HACK
+        image = assembler::assemble(asm_code, opts.optimize_code, nullptr,
+                                    opts.write_symbols ? &symbols : nullptr);
+        timer.lap("assemble");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    if (opts.keep_temps) {
+        // same layout build.sh leaves behind: <out dir>/src/Xxx.vm and src.asm,
+        // also when the image is too large to write
+        fs::path temps_dir = opts.output.parent_path() / "src";
+        fs::create_directories(temps_dir);
+        for (const auto& module : modules) {
+            std::ofstream vm_file(temps_dir / (module.name + ".vm"));
+            for (const auto& command : module.commands) {
+                vm_file << command << '\n';
+            }
+        }
+        std::ofstream asm_file(temps_dir / "src.asm", std::ios::binary);
+        asm_file.write(asm_code.data(), asm_code.size());
+    }
+
+    if (image.size() > ROM_SIZE) {
+        std::cerr << "[Error] program of " << image.size() << " words does not fit in the 32K ROM"
+                  << " (--incremental -O drops the code nothing calls)\n";
+        return 1;
+    }
+    std::ofstream hack_file(opts.output, std::ios::binary);
+    if (!hack_file.is_open()) {
+        std::cerr << "[Error] Unable to create output file: " << opts.output.string() << "\n";
+        return 1;
+    }
+    assembler::writeRom(image, opts.format, hack_file);
+    hack_file.close();
+
+    if (opts.write_symbols) {
+        std::ofstream sym_file(fs::path(opts.output).replace_extension(".sym"));
+        symbols.write(sym_file);
+    }
+    timer.lap("write");
+
+    std::cout << "Build complete: " << opts.output.string() << "\n";
+    timer.report(std::cout);
+    return 0;
+}
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+# driver checks: hackc builds the same image as build.sh running the
+# separate tools, for every test program, and rejects the images larger than
+# the ROM without writing them
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$REPO"
+mkdir -p "$WORK/hackc"
+
+for program in compiler/test_programs/*/; do
+    name="$(basename "$program")"
+    BUILD_DIR="$WORK/build.sh/$name" COMPILER="$BIN/j" VM_TRANSLATOR="$BIN/VirtualMachine" \
+        ASSEMBLER="$BIN/Assembler" ./build.sh "$program" > "$WORK/build.sh.log" ||
+        { cat "$WORK/build.sh.log" >&2; fail "build.sh $program"; }
+    words="$(wc -l < "$WORK/build.sh/$name/o.hack")"
+    if (( words > 32768 )); then
+        "$BIN/hackc" "$program" -o "$WORK/hackc/$name.hack" > "$WORK/hackc.log" 2>&1 &&
+            fail "$name: hackc wrote $words words"
+        grep -q "program of $words words does not fit" "$WORK/hackc.log" ||
+            { cat "$WORK/hackc.log" >&2; fail "$name: no size error from hackc"; }
+        [[ ! -e "$WORK/hackc/$name.hack" ]] || fail "$name: hackc wrote an oversize image"
+        ok "$name: hackc rejects its $words words"
+        continue
+    fi
+    hackc "$program" -o "$WORK/hackc/$name.hack"
+    same "$name: hackc matches build.sh" "$WORK/build.sh/$name/o.hack" "$WORK/hackc/$name.hack"
+done
+
+# Features with the stock OS is 32861 words, and fits once --incremental drops
+# the code nothing calls
+"$BIN/hackc" compiler/test/Features -o "$WORK/features/o.hack" > "$WORK/hackc.log" 2>&1 &&
+    fail "Features: hackc wrote 32861 words"
+grep -q "program of 32861 words does not fit" "$WORK/hackc.log" ||
+    { cat "$WORK/hackc.log" >&2; fail "Features: no size error from hackc"; }
+[[ ! -e "$WORK/features/o.hack" ]] || fail "Features: hackc wrote an oversize image"
+hackc compiler/test/Features -o "$WORK/features/o.hack" --incremental
+ok "Features: hackc rejects its 32861 words, and links it with --incremental"
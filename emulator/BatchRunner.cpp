@@ -0,0 +1,291 @@
+// BatchRunner.cpp
+// runs every job of a manifest on the emulator, spread over all cores by a
+// work-stealing thread pool, and reports the results as JSON. a job is a ROM
+// image, an optional key script, a cycle limit and an optional expected hash
+// of the RAM or the screen; each image is loaded and predecoded once and its
+// ROM shared by all the jobs that run it.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <filesystem>
+#include <chrono>
+#include <iomanip>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Cpu.h"
+#include "KeyScript.h"
+#include "ThreadPool.h"
+#include "../assembler/RomImage.h"
+
+namespace {
+
+void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <manifest> [-j <threads>] [-o <results.json>]\n"
+              << "  -j <threads>   worker threads (default: one per hardware thread)\n"
+              << "  -o <file>      write the JSON results to file instead of stdout\n"
+              << "  manifest lines are \"<image> <keys|-> <cycles> <expected|->\", where expected\n"
+              << "  is ram:<hash> or screen:<hash>, the FNV-1a 64-bit hash of the RAM or screen\n"
+              << "  words in hex; paths are relative to the manifest, # starts a comment\n"
+              << "  exits with 1 if any job fails its expected hash or cannot run\n";
+}
+
+struct Job {
+    std::string image;
+    std::string keys; // empty for none
+    uint64_t cycles;
+    std::string expected_kind; // "ram", "screen" or empty
+    uint64_t expected_hash = 0;
+    unsigned int line;
+};
+
+struct Result {
+    std::string status = "error"; // pass, fail, ran or error
+    std::string error;
+    uint64_t cycles = 0;
+    bool halted = false;
+    uint16_t pc = 0;
+    uint64_t ram_hash = 0;
+    uint64_t screen_hash = 0;
+    double seconds = 0;
+};
+
+// FNV-1a over the little-endian bytes of the words
+uint64_t hashWords(const uint16_t* words, size_t count) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < count; ++i) {
+        hash = (hash ^ (words[i] & 0xFF)) * 0x100000001b3ull;
+        hash = (hash ^ (words[i] >> 8)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string hex(uint64_t value) {
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << value;
+    return out.str();
+}
+
+std::string quote(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::ostringstream code;
+            code << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+            out += code.str();
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+std::vector<Job> readManifest(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("[Error] cannot open " + path);
+    std::filesystem::path base = std::filesystem::path(path).parent_path();
+    auto resolve = [&](const std::string& file) { return (base / file).lexically_normal().string(); };
+
+    std::vector<Job> jobs;
+    std::string line;
+    for (unsigned int number = 1; std::getline(in, line); ++number) {
+        std::string::size_type comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        std::string image, keys, cycles, expected, extra;
+        if (!(fields >> image)) continue;
+        auto bad = [&](const std::string& why) {
+            return std::runtime_error("[Error] " + path + ":" + std::to_string(number) + ": " + why);
+        };
+        if (!(fields >> keys >> cycles >> expected) || (fields >> extra)) {
+            throw bad("expected <image> <keys|-> <cycles> <expected|->");
+        }
+
+        Job job;
+        job.image = resolve(image);
+        if (keys != "-") job.keys = resolve(keys);
+        job.line = number;
+        if (cycles.empty() || cycles.find_first_not_of("0123456789") != std::string::npos) {
+            throw bad("cycle limit '" + cycles + "' is not a number");
+        }
+        job.cycles = std::stoull(cycles);
+        if (expected != "-") {
+            std::string::size_type colon = expected.find(':');
+            std::string digits = colon == std::string::npos ? "" : expected.substr(colon + 1);
+            job.expected_kind = expected.substr(0, colon);
+            if ((job.expected_kind != "ram" && job.expected_kind != "screen") || digits.empty() ||
+                digits.size() > 16 || digits.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+                throw bad("expected '" + expected + "' is not ram:<hex> or screen:<hex>");
+            }
+            job.expected_hash = std::stoull(digits, nullptr, 16);
+        }
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+// runs cpu for up to cycles instructions, setting KBD as the script says
+uint64_t runWithKeys(emulator::Cpu& cpu, uint64_t cycles, const std::vector<emulator::KeyEvent>& keys) {
+    uint64_t executed = 0;
+    size_t key = 0;
+    for (;;) {
+        for (; key < keys.size() && keys[key].cycle <= executed; ++key) {
+            cpu.ram[emulator::KBD] = keys[key].key;
+        }
+        if (executed == cycles || cpu.halted()) break;
+        uint64_t until = key < keys.size() ? std::min(cycles, keys[key].cycle) : cycles;
+        executed += cpu.run(until - executed);
+    }
+    return executed;
+}
+
+void writeJson(std::ostream& out, const std::vector<Job>& jobs, const std::vector<Result>& results,
+               unsigned int threads, size_t steals, double seconds) {
+    uint64_t total_cycles = 0;
+    std::map<std::string, size_t> counts{{"pass", 0}, {"fail", 0}, {"ran", 0}, {"error", 0}};
+    out << "{\n  \"jobs\": [";
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const Job& job = jobs[i];
+        const Result& result = results[i];
+        total_cycles += result.cycles;
+        ++counts[result.status];
+        out << (i ? ",\n" : "\n") << "    {\"line\": " << job.line
+            << ", \"image\": " << quote(job.image)
+            << ", \"keys\": " << (job.keys.empty() ? "null" : quote(job.keys))
+            << ", \"max_cycles\": " << job.cycles
+            << ", \"status\": " << quote(result.status);
+        if (result.status == "error") {
+            out << ", \"error\": " << quote(result.error) << "}";
+            continue;
+        }
+        out << ", \"cycles\": " << result.cycles
+            << ", \"halted\": " << (result.halted ? "true" : "false")
+            << ", \"pc\": " << result.pc
+            << ", \"ram_hash\": \"" << hex(result.ram_hash) << "\""
+            << ", \"screen_hash\": \"" << hex(result.screen_hash) << "\"";
+        if (!job.expected_kind.empty()) {
+            out << ", \"expected\": \"" << job.expected_kind << ":" << hex(job.expected_hash) << "\"";
+        }
+        out << ", \"seconds\": " << std::fixed << std::setprecision(6) << result.seconds << "}";
+    }
+    out << (jobs.empty() ? "],\n" : "\n  ],\n")
+        << "  \"summary\": {\"jobs\": " << jobs.size()
+        << ", \"pass\": " << counts["pass"] << ", \"fail\": " << counts["fail"]
+        << ", \"ran\": " << counts["ran"] << ", \"error\": " << counts["error"]
+        << ", \"instructions\": " << total_cycles
+        << ", \"seconds\": " << std::fixed << std::setprecision(6) << seconds
+        << ", \"mips\": " << std::setprecision(2) << (seconds > 0 ? total_cycles / seconds / 1e6 : 0.0)
+        << ", \"threads\": " << threads << ", \"steals\": " << steals << "}\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string manifest_path;
+    std::string output_path;
+    unsigned int threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            threads = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "-o" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (manifest_path.empty() && !arg.empty() && arg[0] != '-') {
+            manifest_path = arg;
+        } else {
+            manifest_path.clear();
+            break;
+        }
+    }
+    if (manifest_path.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::vector<Job> jobs = readManifest(manifest_path);
+
+        // every image and key script once, up front; a job whose files cannot
+        // be read is an error result rather than the end of the batch
+        std::map<std::string, std::shared_ptr<const emulator::Cpu::Program>> programs;
+        std::map<std::string, std::vector<emulator::KeyEvent>> scripts;
+        std::map<std::string, std::string> load_errors;
+        for (const Job& job : jobs) {
+            if (!programs.count(job.image) && !load_errors.count(job.image)) {
+                try {
+                    programs[job.image] = emulator::Cpu::decodeProgram(assembler::readRom(job.image));
+                } catch (const std::exception& e) {
+                    load_errors[job.image] = e.what();
+                }
+            }
+            if (!job.keys.empty() && !scripts.count(job.keys) && !load_errors.count(job.keys)) {
+                try {
+                    std::ifstream in(job.keys);
+                    if (!in) throw std::runtime_error("[Error] cannot open " + job.keys);
+                    scripts[job.keys] = emulator::readKeyScript(in);
+                } catch (const std::exception& e) {
+                    load_errors[job.keys] = e.what();
+                }
+            }
+        }
+
+        std::vector<Result> results(jobs.size());
+        emulator::ThreadPool pool(threads);
+        auto start = std::chrono::steady_clock::now();
+        pool.run(jobs.size(), [&](size_t index) {
+            const Job& job = jobs[index];
+            Result& result = results[index];
+            for (const std::string* file : {&job.image, &job.keys}) {
+                auto error = load_errors.find(*file);
+                if (error != load_errors.end()) {
+                    result.error = error->second;
+                    return;
+                }
+            }
+            static const std::vector<emulator::KeyEvent> no_keys;
+            const auto& keys = job.keys.empty() ? no_keys : scripts.at(job.keys);
+
+            auto job_start = std::chrono::steady_clock::now();
+            emulator::Cpu cpu(programs.at(job.image));
+            result.cycles = runWithKeys(cpu, job.cycles, keys);
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job_start).count();
+            result.halted = cpu.halted();
+            result.pc = cpu.pc;
+            result.ram_hash = hashWords(cpu.ram.data(), emulator::RAM_SIZE);
+            result.screen_hash = hashWords(cpu.ram.data() + emulator::SCREEN, emulator::SCREEN_SIZE);
+            if (job.expected_kind.empty()) {
+                result.status = "ran";
+            } else {
+                uint64_t actual = job.expected_kind == "ram" ? result.ram_hash : result.screen_hash;
+                result.status = actual == job.expected_hash ? "pass" : "fail";
+            }
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (output_path.empty()) {
+            writeJson(std::cout, jobs, results, pool.size(), pool.steals(), seconds);
+        } else {
+            std::ofstream out(output_path);
+            if (!out) throw std::runtime_error("[Error] cannot write " + output_path);
+            writeJson(out, jobs, results, pool.size(), pool.steals(), seconds);
+        }
+
+        bool ok = std::all_of(results.begin(), results.end(), [](const Result& r) {
+            return r.status == "pass" || r.status == "ran";
+        });
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
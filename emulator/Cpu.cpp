@@ -0,0 +1,226 @@
+#include "Cpu.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace emulator {
+
+namespace {
+
+constexpr uint16_t GOTO_WORD = 0xEA87; // 0;JMP
+
+// every comp with its own handlers: name, a and c bits, result. GENERIC
+// covers the c bit patterns outside the standard 28.
+#define HACK_COMPS(X)                                   \
+    X(GENERIC,   0xFF, Cpu::compute(op->alu, d, a, M_)) \
+    X(ZERO,      0x2A, 0)                               \
+    X(ONE,       0x3F, 1)                               \
+    X(MINUS_ONE, 0x3A, 0xFFFF)                          \
+    X(D,         0x0C, d)                               \
+    X(A,         0x30, a)                               \
+    X(M,         0x70, M_)                              \
+    X(NOT_D,     0x0D, ~d)                              \
+    X(NOT_A,     0x31, ~a)                              \
+    X(NOT_M,     0x71, ~M_)                             \
+    X(NEG_D,     0x0F, -d)                              \
+    X(NEG_A,     0x33, -a)                              \
+    X(NEG_M,     0x73, -M_)                             \
+    X(D_PLUS_1,  0x1F, d + 1)                           \
+    X(A_PLUS_1,  0x37, a + 1)                           \
+    X(M_PLUS_1,  0x77, M_ + 1)                          \
+    X(D_MINUS_1, 0x0E, d - 1)                           \
+    X(A_MINUS_1, 0x32, a - 1)                           \
+    X(M_MINUS_1, 0x72, M_ - 1)                          \
+    X(D_PLUS_A,  0x02, d + a)                           \
+    X(D_PLUS_M,  0x42, d + M_)                          \
+    X(D_MINUS_A, 0x13, d - a)                           \
+    X(D_MINUS_M, 0x53, d - M_)                          \
+    X(A_MINUS_D, 0x07, a - d)                           \
+    X(M_MINUS_D, 0x47, M_ - d)                          \
+    X(D_AND_A,   0x00, d & a)                           \
+    X(D_AND_M,   0x40, d & M_)                          \
+    X(D_OR_A,    0x15, d | a)                           \
+    X(D_OR_M,    0x55, d | M_)
+
+// each comp gets a handler per dest (0-7: M=1, D=2, A=4) and per
+// "jumps or not", so the common path has no branches on the instruction bits
+#define HACK_DESTS(X, comp, expr)                                        \
+    X(comp, 0, expr) X(comp, 1, expr) X(comp, 2, expr) X(comp, 3, expr)  \
+    X(comp, 4, expr) X(comp, 5, expr) X(comp, 6, expr) X(comp, 7, expr)
+
+enum Comp : uint8_t {
+#define COMP_ENUM(name, bits, expr) COMP_##name,
+    HACK_COMPS(COMP_ENUM)
+#undef COMP_ENUM
+    COMP_COUNT
+};
+
+enum Handler : uint16_t {
+    LOAD, HALT,
+#define HANDLER_ENUM(comp, dest, expr) comp##_##dest##_NEXT, comp##_##dest##_JUMP,
+#define COMP_HANDLERS(name, bits, expr) HACK_DESTS(HANDLER_ENUM, name, expr)
+    HACK_COMPS(COMP_HANDLERS)
+#undef COMP_HANDLERS
+#undef HANDLER_ENUM
+    HANDLER_COUNT
+};
+
+// comp of each a and c bit pattern
+struct CompTable {
+    uint8_t comp[128];
+
+    constexpr CompTable() : comp() {
+        for (uint8_t& c : comp) c = COMP_GENERIC;
+#define COMP_ENTRY(name, bits, expr) if (bits < 128) comp[bits] = COMP_##name;
+        HACK_COMPS(COMP_ENTRY)
+#undef COMP_ENTRY
+    }
+};
+
+constexpr CompTable comp_table;
+
+} // namespace
+
+std::shared_ptr<const Cpu::Program> Cpu::decodeProgram(const std::vector<uint16_t>& rom) {
+    if (rom.size() > ROM_SIZE) {
+        throw std::runtime_error("[Error] program of " + std::to_string(rom.size()) +
+                                 " words does not fit in the 32K ROM");
+    }
+    // words past the end of the program are 0, i.e. @0
+    std::vector<uint16_t> words(rom);
+    words.resize(ROM_SIZE, 0);
+    auto ops = std::make_shared<Program>(ROM_SIZE);
+    for (unsigned int address = 0; address < ROM_SIZE; ++address) {
+        (*ops)[address] = decode(words, address);
+    }
+    return ops;
+}
+
+Cpu::Cpu(const std::vector<uint16_t>& rom) : Cpu(decodeProgram(rom)) {}
+
+Cpu::Cpu(std::shared_ptr<const Program> program) : ram(RAM_SIZE, 0), program(std::move(program)) {}
+
+Cpu::Op Cpu::decode(const std::vector<uint16_t>& rom, unsigned int address) {
+    uint16_t word = rom[address];
+    Op op{};
+    if (!(word & 0x8000)) {
+        bool halt_loop = (word == address && address + 1 < ROM_SIZE && rom[address + 1] == GOTO_WORD);
+        op.handler = halt_loop ? HALT : LOAD;
+        op.value = word;
+        return op;
+    }
+    op.alu = (word >> 6) & 0x7F;
+    op.jump = word & 0x7;
+    unsigned int dest = (word >> 3) & 0x7;
+    op.handler = GENERIC_0_NEXT + (comp_table.comp[op.alu] * 8 + dest) * 2 + (op.jump != 0);
+    return op;
+}
+
+void Cpu::reset() {
+    pc = a = d = 0;
+    is_halted = false;
+}
+
+uint16_t Cpu::compute(uint8_t alu, uint16_t d, uint16_t a, uint16_t m) {
+    uint16_t x = d;
+    uint16_t y = (alu & 0x40) ? m : a;
+    if (alu & 0x20) x = 0;      // zx
+    if (alu & 0x10) x = ~x;     // nx
+    if (alu & 0x08) y = 0;      // zy
+    if (alu & 0x04) y = ~y;     // ny
+    uint16_t out = (alu & 0x02) ? x + y : x & y; // f
+    if (alu & 0x01) out = ~out; // no
+    return out;
+}
+
+uint64_t Cpu::run(uint64_t cycles) {
+    // registers live in locals for the duration of the loop
+    uint16_t pc = this->pc, a = this->a, d = this->d;
+    uint16_t* const mem = ram.data();
+    const Op* const rom = program->data();
+    const Op* op = nullptr;
+    uint64_t executed = 0;
+
+#define M_ (mem[a & 0x7FFF])
+
+// writes of each dest; M goes first, it is addressed by A before the write
+#define WRITE_0 (void)out;
+#define WRITE_1 M_ = out;
+#define WRITE_2 d = out;
+#define WRITE_3 M_ = out; d = out;
+#define WRITE_4 a = out;
+#define WRITE_5 M_ = out; a = out;
+#define WRITE_6 a = out; d = out;
+#define WRITE_7 M_ = out; a = out; d = out;
+
+#if defined(__GNUC__)
+    // threaded dispatch through GCC's labels as values; same order as Handler
+    static void* const handlers[HANDLER_COUNT] = {
+        &&h_LOAD, &&h_HALT,
+#define HANDLER_ADDRESS(comp, dest, expr) &&h_##comp##_##dest##_NEXT, &&h_##comp##_##dest##_JUMP,
+#define COMP_ADDRESSES(name, bits, expr) HACK_DESTS(HANDLER_ADDRESS, name, expr)
+        HACK_COMPS(COMP_ADDRESSES)
+#undef COMP_ADDRESSES
+#undef HANDLER_ADDRESS
+    };
+#define HANDLER(name) h_##name:
+#define DISPATCH()                              \
+    do {                                        \
+        if (executed == cycles) goto done;      \
+        op = &rom[pc];                          \
+        ++executed;                             \
+        goto *handlers[op->handler];            \
+    } while (0)
+
+    DISPATCH();
+#else
+#define HANDLER(name) case name:
+#define DISPATCH() continue
+
+    for (;;) {
+        if (executed == cycles) goto done;
+        op = &rom[pc];
+        ++executed;
+        switch (op->handler) {
+#endif
+
+    HANDLER(LOAD)
+        a = op->value;
+        pc = (pc + 1) & 0x7FFF;
+        DISPATCH();
+    HANDLER(HALT)
+        --executed;
+        is_halted = true;
+        goto done;
+
+#define COMPUTE_HANDLERS(comp, dest, expr)                                         \
+    HANDLER(comp##_##dest##_NEXT) {                                             \
+        uint16_t out = (expr);                                                  \
+        WRITE_##dest                                                            \
+        pc = (pc + 1) & 0x7FFF;                                                 \
+        DISPATCH();                                                             \
+    }                                                                           \
+    HANDLER(comp##_##dest##_JUMP) {                                             \
+        uint16_t target = a;                                                    \
+        uint16_t out = (expr);                                                  \
+        WRITE_##dest                                                            \
+        unsigned int flag = (out == 0) ? 2 : (out & 0x8000) ? 4 : 1;            \
+        pc = (op->jump & flag) ? (target & 0x7FFF) : ((pc + 1) & 0x7FFF);       \
+        DISPATCH();                                                             \
+    }
+#define COMP_BODIES(name, bits, expr) HACK_DESTS(COMPUTE_HANDLERS, name, expr)
+    HACK_COMPS(COMP_BODIES)
+
+#if !defined(__GNUC__)
+        }
+    }
+#endif
+
+done:
+    this->pc = pc;
+    this->a = a;
+    this->d = d;
+    return executed;
+}
+
+} // namespace emulator
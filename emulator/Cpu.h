@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace emulator {
+
+// Hack memory map
+constexpr unsigned int ROM_SIZE = 32768;
+constexpr unsigned int RAM_SIZE = 32768;
+constexpr unsigned int SCREEN = 16384;      // 8K words, 32 per row of 512 pixels
+constexpr unsigned int SCREEN_SIZE = 8192;
+constexpr unsigned int KBD = 24576;
+
+// the Hack CPU of hack_computer/cpu.v with 32K of ROM and RAM. The ROM is
+// predecoded once into ops that the run loop dispatches on directly; RAM
+// holds the screen and keyboard maps like any other word.
+class Cpu {
+public:
+    // one predecoded ROM word
+    struct Op {
+        uint16_t handler; // run loop handler: load, halt, or comp x dest x jumps
+        uint16_t value;   // A: the constant
+        uint8_t jump;     // C: the j bits (lt=4, eq=2, gt=1)
+        uint8_t alu;      // C: the a and c bits, for comps outside the standard 28
+    };
+
+    // a predecoded ROM; read-only, so any number of Cpus can share one
+    using Program = std::vector<Op>;
+    static std::shared_ptr<const Program> decodeProgram(const std::vector<uint16_t>& rom);
+
+    explicit Cpu(const std::vector<uint16_t>& rom);
+    explicit Cpu(std::shared_ptr<const Program> program);
+
+    // pc, A and D to 0 (RAM is kept, like the hardware reset)
+    void reset();
+
+    // executes at most cycles instructions and returns how many ran; stops
+    // early at a halt loop, "(L) @L 0;JMP"
+    uint64_t run(uint64_t cycles);
+
+    bool halted() const { return is_halted; }
+
+    uint16_t pc = 0;
+    uint16_t a = 0;
+    uint16_t d = 0;
+    std::vector<uint16_t> ram;
+
+    // the ALU of alu.v; alu is the a bit and the six c bits
+    static uint16_t compute(uint8_t alu, uint16_t d, uint16_t a, uint16_t m);
+
+private:
+    std::shared_ptr<const Program> program;
+    bool is_halted = false;
+
+    static Op decode(const std::vector<uint16_t>& rom, unsigned int address);
+};
+
+} // namespace emulator
@@ -0,0 +1,346 @@
+// Emulator.cpp
+// runs a Hack ROM image (.hack, .bin or .hex from the assembler or linker)
+// headless on the native Hack CPU emulator, its x86-64 JIT or 8 to 32 lockstep
+// lanes at once and reports the instruction rate. the keyboard can be driven from a
+// timed key script, the screen captured to PBM or PNG at given cycles, and the
+// RAM dumped on exit.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <iomanip>
+#include <exception>
+#include <algorithm>
+#include <limits>
+
+#include "Cpu.h"
+#include "Jit.h"
+#include "KeyScript.h"
+#include "Screen.h"
+#include "Profiler.h"
+#include "Lockstep.h"
+#include "../assembler/SymbolFile.h"
+#include "../assembler/RomImage.h"
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <image.hack|.bin|.hex> [--jit | --check | --profile <image.sym>]\n"
+              << "                [--lanes <8|16|32> [--sweep <address> <first> <step>]...]\n"
+              << "                [--max-cycles <n>] [--keys <script>] [--screen <cycle|end> <file>]... [--dump <ram file>]\n"
+              << "  --jit              translate the program to x86-64 as it runs\n"
+              << "  --check            run both the interpreter and the JIT and compare the results;\n"
+              << "                     with --lanes, run every lane on the interpreter and compare\n"
+              << "  --lanes <n>        run n copies of the program in lockstep; --keys may then be\n"
+              << "                     given per lane (lane i replays script i mod the count)\n"
+              << "  --sweep <address> <first> <step>\n"
+              << "                     with --lanes, start lane i with RAM[address] = first + i * step\n"
+              << "  --profile <sym>    count the instructions of every function and call stack, using\n"
+              << "                     the symbol file from -g; prints the top functions\n"
+              << "  --folded <file>    with --profile, also write the call stacks in folded format\n"
+              << "  --max-cycles <n>   stop after n instructions (default: 100000000)\n"
+              << "  --keys <script>    set KBD from a key script of \"<cycle> <key>\" lines\n"
+              << "  --screen <cycle|end> <file>\n"
+              << "                     write the screen when cycle instructions have run, as PNG\n"
+              << "                     for .png files and PBM otherwise; may be repeated\n"
+              << "  --dump <file>      write all 32K RAM words on exit, in the ROM image format\n"
+              << "                     given by the extension (.hack, .bin or .hex); lane 0's with --lanes\n"
+              << "  execution also stops at a halt loop, (L) @L 0;JMP; screens due after that\n"
+              << "  are taken of the final state\n";
+}
+
+// a screen capture requested with --screen
+struct Capture {
+    uint64_t cycle;
+    std::string path;
+};
+
+// runs machine for up to max_cycles in slices, setting KBD and writing the
+// captures as their cycles come up
+template <typename Machine>
+static uint64_t runScripted(Machine& machine, uint64_t max_cycles,
+                            const std::vector<emulator::KeyEvent>& keys,
+                            const std::vector<Capture>& captures) {
+    uint64_t executed = 0;
+    size_t key = 0, capture = 0;
+    for (;;) {
+        for (; key < keys.size() && keys[key].cycle <= executed; ++key) {
+            machine.ram[emulator::KBD] = keys[key].key;
+        }
+        for (; capture < captures.size() && captures[capture].cycle <= executed; ++capture) {
+            emulator::writeScreen(machine.ram, captures[capture].path);
+        }
+        if (executed == max_cycles || machine.halted()) break;
+
+        uint64_t until = max_cycles;
+        if (key < keys.size()) until = std::min(until, keys[key].cycle);
+        if (capture < captures.size()) until = std::min(until, captures[capture].cycle);
+        executed += machine.run(until - executed);
+    }
+    for (; capture < captures.size(); ++capture) {
+        emulator::writeScreen(machine.ram, captures[capture].path);
+    }
+    return executed;
+}
+
+// runs machine and reports the outcome and the instruction rate
+template <typename Machine>
+static uint64_t runTimed(Machine& machine, uint64_t max_cycles, const char* name,
+                         const std::vector<emulator::KeyEvent>& keys,
+                         const std::vector<Capture>& captures) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t cycles = runScripted(machine, max_cycles, keys, captures);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": " << (machine.halted() ? "Halted" : "Cycle limit reached") << " after "
+              << cycles << " instructions at pc " << machine.pc << "\n"
+              << "  " << std::fixed << std::setprecision(2) << seconds * 1000 << " ms, "
+              << (seconds > 0 ? cycles / seconds / 1e6 : 0.0) << " MIPS\n"
+              << "  SP " << machine.ram[0] << "  LCL " << machine.ram[1] << "  ARG " << machine.ram[2]
+              << "  THIS " << machine.ram[3] << "  THAT " << machine.ram[4] << "\n";
+    return cycles;
+}
+
+// the first difference between the interpreter and the JIT (or a lane), or empty
+template <typename Machine>
+static std::string compare(const emulator::Cpu& cpu, uint64_t cpu_cycles,
+                           const Machine& jit, uint64_t jit_cycles) {
+    if (cpu_cycles != jit_cycles) {
+        return "instructions run: " + std::to_string(cpu_cycles) + " vs " + std::to_string(jit_cycles);
+    }
+    if (cpu.halted() != jit.halted()) return "halted state";
+    if (cpu.pc != jit.pc) return "PC: " + std::to_string(cpu.pc) + " vs " + std::to_string(jit.pc);
+    if (cpu.a != jit.a) return "A: " + std::to_string(cpu.a) + " vs " + std::to_string(jit.a);
+    if (cpu.d != jit.d) return "D: " + std::to_string(cpu.d) + " vs " + std::to_string(jit.d);
+    for (size_t address = 0; address < cpu.ram.size(); ++address) {
+        if (cpu.ram[address] != jit.ram[address]) {
+            return "RAM[" + std::to_string(address) + "]: " + std::to_string(cpu.ram[address]) +
+                   " vs " + std::to_string(jit.ram[address]);
+        }
+    }
+    return "";
+}
+
+// a RAM word set per lane with --sweep
+struct Sweep {
+    uint16_t address;
+    uint16_t first;
+    uint16_t step;
+};
+
+// the final state of one lockstep lane, to compare with the interpreter
+struct LaneState {
+    bool is_halted;
+    uint16_t pc, a, d;
+    std::vector<uint16_t> ram;
+    bool halted() const { return is_halted; }
+};
+
+// runs Lanes copies of the program in lockstep and reports the lanes, the
+// occupancy and the aggregate instruction rate; with check, replays every
+// lane on the interpreter. ram gets lane 0's RAM.
+template <unsigned int Lanes>
+static bool runLanes(const std::vector<uint16_t>& rom, uint64_t max_cycles,
+                     const std::vector<std::vector<emulator::KeyEvent>>& scripts,
+                     const std::vector<Sweep>& sweeps, bool check, std::vector<uint16_t>& ram) {
+    auto setUp = [&](unsigned int lane, auto&& poke) {
+        for (const Sweep& sweep : sweeps) {
+            poke(sweep.address, static_cast<uint16_t>(sweep.first + lane * sweep.step));
+        }
+    };
+    const std::vector<emulator::KeyEvent> no_keys;
+    auto keysOf = [&](unsigned int lane) -> const std::vector<emulator::KeyEvent>& {
+        return scripts.empty() ? no_keys : scripts[lane % scripts.size()];
+    };
+
+    emulator::Lockstep<Lanes> lanes(rom);
+    for (unsigned int lane = 0; lane < Lanes; ++lane) {
+        setUp(lane, [&](uint16_t address, uint16_t value) { lanes.poke(lane, address, value); });
+        lanes.setKeys(lane, keysOf(lane));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total = lanes.run(max_cycles);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned int halted = 0;
+    for (unsigned int lane = 0; lane < Lanes; ++lane) halted += lanes.halted(lane);
+    double mips = seconds > 0 ? total / seconds / 1e6 : 0.0;
+    std::cout << "Lockstep: " << halted << " of " << Lanes << " lanes halted, " << total
+              << " instructions in all\n"
+              << "  " << std::fixed << std::setprecision(2) << seconds * 1000 << " ms, " << mips
+              << " MIPS aggregate (" << mips / Lanes << " per lane)\n"
+              << "  occupancy " << lanes.occupancy() * 100 << "% over " << lanes.issued()
+              << " issued instructions, " << lanes.scalarIssued() << " of them scalar\n";
+    for (unsigned int lane = 0; lane < Lanes; ++lane) {
+        std::cout << "  lane " << std::setw(2) << lane << ": "
+                  << (lanes.halted(lane) ? "halted" : "cycle limit") << " after " << lanes.cycles(lane)
+                  << " instructions at pc " << lanes.pc(lane) << ", SP " << lanes.peek(lane, 0) << "\n";
+    }
+    ram = lanes.ram(0);
+
+    if (check) {
+        for (unsigned int lane = 0; lane < Lanes; ++lane) {
+            emulator::Cpu cpu(rom);
+            setUp(lane, [&](uint16_t address, uint16_t value) { cpu.ram[address & 0x7FFF] = value; });
+            uint64_t cpu_cycles = runScripted(cpu, max_cycles, keysOf(lane), {});
+            LaneState state{lanes.halted(lane), lanes.pc(lane), lanes.a(lane), lanes.d(lane), lanes.ram(lane)};
+            std::string difference = compare(cpu, cpu_cycles, state, lanes.cycles(lane));
+            if (!difference.empty()) {
+                std::cerr << "[Error] lane " << lane << " and the interpreter differ in " << difference << "\n";
+                return false;
+            }
+        }
+        std::cout << "All " << Lanes << " lanes agree with the interpreter\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string image_path;
+    std::string dump_path;
+    uint64_t max_cycles = 100000000;
+    bool use_jit = false;
+    bool check = false;
+    std::vector<std::string> keys_paths;
+    std::vector<Capture> captures;
+    unsigned int lane_count = 0;
+    std::vector<Sweep> sweeps;
+    std::string profile_path;
+    std::string folded_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--jit") {
+            use_jit = true;
+        } else if (arg == "--check") {
+            check = true;
+        } else if (arg == "--max-cycles" && i + 1 < argc) {
+            max_cycles = std::stoull(argv[++i]);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (arg == "--folded" && i + 1 < argc) {
+            folded_path = argv[++i];
+        } else if (arg == "--keys" && i + 1 < argc) {
+            keys_paths.push_back(argv[++i]);
+        } else if (arg == "--lanes" && i + 1 < argc) {
+            lane_count = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--sweep" && i + 3 < argc) {
+            Sweep sweep;
+            sweep.address = static_cast<uint16_t>(std::stoul(argv[++i]));
+            sweep.first = static_cast<uint16_t>(std::stol(argv[++i]));
+            sweep.step = static_cast<uint16_t>(std::stol(argv[++i]));
+            sweeps.push_back(sweep);
+        } else if (arg == "--screen" && i + 2 < argc) {
+            std::string cycle = argv[++i];
+            uint64_t at = (cycle == "end") ? std::numeric_limits<uint64_t>::max() : std::stoull(cycle);
+            captures.push_back({at, argv[++i]});
+        } else if (arg == "--dump" && i + 1 < argc) {
+            dump_path = argv[++i];
+        } else if (image_path.empty() && !arg.empty() && arg[0] != '-') {
+            image_path = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (image_path.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bool profile = !profile_path.empty();
+    bool lockstep = lane_count != 0;
+    if ((use_jit + check + profile) > 1 || (!folded_path.empty() && !profile)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (lockstep ? (use_jit || profile || !captures.empty() ||
+                    (lane_count != 8 && lane_count != 16 && lane_count != 32))
+                 : (keys_paths.size() > 1 || !sweeps.empty())) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // captures in cycle order, keeping the command line order for equal cycles
+    std::stable_sort(captures.begin(), captures.end(),
+                     [](const Capture& x, const Capture& y) { return x.cycle < y.cycle; });
+
+    try {
+        std::vector<uint16_t> rom = assembler::readRom(image_path);
+        std::vector<uint16_t> ram;
+
+        std::vector<std::vector<emulator::KeyEvent>> scripts;
+        for (const std::string& keys_path : keys_paths) {
+            std::ifstream keys_file(keys_path);
+            if (!keys_file.is_open()) {
+                std::cerr << "[Error] Unable to open key script: " << keys_path << "\n";
+                return 1;
+            }
+            scripts.push_back(emulator::readKeyScript(keys_file));
+        }
+        std::vector<emulator::KeyEvent> keys = scripts.empty() ? std::vector<emulator::KeyEvent>() : scripts[0];
+
+        if (lockstep) {
+            bool agree = (lane_count == 8)  ? runLanes<8>(rom, max_cycles, scripts, sweeps, check, ram)
+                       : (lane_count == 16) ? runLanes<16>(rom, max_cycles, scripts, sweeps, check, ram)
+                                            : runLanes<32>(rom, max_cycles, scripts, sweeps, check, ram);
+            if (!agree) return 1;
+        } else if (profile) {
+            std::ifstream sym_file(profile_path);
+            if (!sym_file.is_open()) {
+                std::cerr << "[Error] Unable to open symbol file: " << profile_path << "\n";
+                return 1;
+            }
+            emulator::Profiler profiler(rom, assembler::SymbolFile::read(sym_file));
+            runTimed(profiler, max_cycles, "Profiler", keys, captures);
+            profiler.writeReport(std::cout, 25);
+            if (!folded_path.empty()) {
+                std::ofstream folded_file(folded_path);
+                if (!folded_file.is_open()) {
+                    std::cerr << "[Error] Unable to create folded stack file: " << folded_path << "\n";
+                    return 1;
+                }
+                profiler.writeFolded(folded_file);
+            }
+            ram = profiler.ram;
+        } else if (use_jit || check) {
+            emulator::Jit jit(rom);
+            uint64_t jit_cycles = runTimed(jit, max_cycles, "JIT", keys, captures);
+            std::cout << "  " << jit.blockCount() << " blocks, " << jit.codeSize() / 1024 << " KB of code\n";
+            if (check) {
+                emulator::Cpu cpu(rom);
+                uint64_t cpu_cycles = runTimed(cpu, max_cycles, "Interpreter", keys, {});
+                std::string difference = compare(cpu, cpu_cycles, jit, jit_cycles);
+                if (!difference.empty()) {
+                    std::cerr << "[Error] JIT and interpreter differ in " << difference << "\n";
+                    return 1;
+                }
+                std::cout << "JIT and interpreter agree\n";
+            }
+            ram = jit.ram;
+        } else {
+            emulator::Cpu cpu(rom);
+            runTimed(cpu, max_cycles, "Interpreter", keys, captures);
+            ram = cpu.ram;
+        }
+
+        if (!dump_path.empty()) {
+            std::string extension = std::filesystem::path(dump_path).extension().string();
+            assembler::RomFormat format = (extension == ".bin") ? assembler::RomFormat::BIN
+                                        : (extension == ".hex") ? assembler::RomFormat::HEX
+                                                                : assembler::RomFormat::ASCII;
+            std::ofstream dump_file(dump_path, std::ios::binary);
+            if (!dump_file.is_open()) {
+                std::cerr << "[Error] Unable to create dump file: " << dump_path << "\n";
+                return 1;
+            }
+            assembler::writeRom(ram, format, dump_file);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,477 @@
+#include "Jit.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#define HACK_JIT 1
+#endif
+
+namespace emulator {
+
+namespace {
+
+constexpr uint16_t GOTO_WORD = 0xEA87; // 0;JMP
+
+// a block ends after this many instructions even without a jump
+constexpr unsigned int MAX_BLOCK = 64;
+
+// generous upper bounds on the code of one block and of the stubs
+constexpr size_t MAX_BLOCK_BYTES = MAX_BLOCK * 48 + 64;
+constexpr size_t CODE_SIZE = 64 << 20;
+
+// why the native code returned to run()
+enum Exit : uint32_t { EXIT_MISS, EXIT_BUDGET, EXIT_HALT };
+
+// what the entry stub loads into registers and the exit stub stores back;
+// offsets are hard-coded in writeStubs()
+struct State {
+    uint16_t* ram;       // 0
+    void** table;        // 8
+    int64_t remaining;   // 16
+    uint32_t a;          // 24
+    uint32_t d;          // 28
+    uint32_t pc;         // 32
+};
+
+using Entry = uint32_t (*)(State*);
+
+// x86-64 registers
+enum Reg : uint8_t {
+    RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+    R12 = 12, R13 = 13, R14 = 14, R15 = 15
+};
+
+// register assignment inside compiled code
+constexpr Reg REG_A = R12;     // A, zero-extended
+constexpr Reg REG_D = R13;     // D, zero-extended
+constexpr Reg REG_BUDGET = R14; // instructions left to run
+constexpr Reg REG_PC = R15;    // PC at block exits
+constexpr Reg REG_RAM = RBX;   // RAM base
+constexpr Reg REG_TABLE = RBP; // block table base
+// eax holds the ALU output, edx the y operand, ecx the masked old A
+
+// condition codes after "test ax, ax", by the j bits (lt=4, eq=2, gt=1)
+constexpr uint8_t JUMP_CC[8] = {0, 0xF /* g */, 0x4 /* e */, 0xD /* ge */,
+                                0xC /* l */, 0x5 /* ne */, 0xE /* le */, 0};
+
+// a word of RAM: at a constant address, or at ecx
+struct Mem {
+    bool indexed;
+    uint32_t address;
+};
+
+// appends machine code; only the handful of instruction forms the
+// translation needs, all on 32-bit registers unless noted
+class Emitter {
+public:
+    explicit Emitter(uint8_t* at) : p(at) {}
+
+    uint8_t* p;
+
+    void byte(uint8_t b) { *p++ = b; }
+    void dword(uint32_t v) { std::memcpy(p, &v, 4); p += 4; }
+
+    void rex(bool w, unsigned int reg, unsigned int base) {
+        uint8_t prefix = 0x40 | (w << 3) | ((reg >> 3) << 2) | (base >> 3);
+        if (prefix != 0x40) byte(prefix);
+    }
+    void modrm(unsigned int mod, unsigned int reg, unsigned int rm) {
+        byte(static_cast<uint8_t>((mod << 6) | ((reg & 7) << 3) | (rm & 7)));
+    }
+
+    // op r/m32, r32 for mov (0x89), add (0x01), sub (0x29), and (0x21), or (0x09), xor (0x31)
+    void rr(uint8_t opcode, Reg dst, Reg src) {
+        rex(false, src, dst);
+        byte(opcode);
+        modrm(3, src, dst);
+    }
+    void mov(Reg dst, Reg src) { rr(0x89, dst, src); }
+    void movImm(Reg dst, uint32_t value) {
+        rex(false, 0, dst);
+        byte(0xB8 + (dst & 7));
+        dword(value);
+    }
+    void zero(Reg r) { rr(0x31, r, r); }
+
+    // not (2) and neg (3)
+    void unary(unsigned int ext, Reg r) {
+        rex(false, 0, r);
+        byte(0xF7);
+        modrm(3, ext, r);
+    }
+    // add (0) and sub (5) of a small immediate
+    void addImm8(unsigned int ext, Reg r, int8_t value) {
+        rex(false, 0, r);
+        byte(0x83);
+        modrm(3, ext, r);
+        byte(static_cast<uint8_t>(value));
+    }
+    void andImm(Reg r, uint32_t value) {
+        rex(false, 0, r);
+        byte(0x81);
+        modrm(3, 4, r);
+        dword(value);
+    }
+    void zeroExtend16(Reg r) {
+        rex(false, r, r);
+        byte(0x0F); byte(0xB7);
+        modrm(3, r, r);
+    }
+    void test16(Reg r) {
+        byte(0x66);
+        rex(false, r, r);
+        byte(0x85);
+        modrm(3, r, r);
+    }
+
+    // [rbx + address*2] or [rbx + rcx*2]
+    void ram(Reg reg, const Mem& mem) {
+        if (mem.indexed) {
+            modrm(0, reg, 4);
+            byte(0x4B); // scale 2, index rcx, base rbx
+        } else {
+            modrm(2, reg, REG_RAM);
+            dword(mem.address * 2);
+        }
+    }
+    void load16(Reg dst, const Mem& mem) {
+        rex(false, dst, 0);
+        byte(0x0F); byte(0xB7);
+        ram(dst, mem);
+    }
+    void store16(const Mem& mem, Reg src) {
+        byte(0x66);
+        rex(false, src, 0);
+        byte(0x89);
+        ram(src, mem);
+    }
+
+    // budget checks on r14
+    void cmpBudget(uint32_t value) {
+        rex(true, 0, REG_BUDGET);
+        byte(0x81);
+        modrm(3, 7, REG_BUDGET);
+        dword(value);
+    }
+    void subBudget(uint32_t value) {
+        rex(true, 0, REG_BUDGET);
+        byte(0x81);
+        modrm(3, 5, REG_BUDGET);
+        dword(value);
+    }
+
+    // rel32 branches; the returned pointer is the displacement to patch
+    uint8_t* jcc(uint8_t cc, const uint8_t* target = nullptr) {
+        byte(0x0F); byte(0x80 | cc);
+        return rel32(target);
+    }
+    uint8_t* jmp(const uint8_t* target = nullptr) {
+        byte(0xE9);
+        return rel32(target);
+    }
+    uint8_t* rel32(const uint8_t* target) {
+        uint8_t* at = p;
+        dword(0);
+        if (target) patch(at, target);
+        return at;
+    }
+    static void patch(uint8_t* at, const uint8_t* target) {
+        int32_t rel = static_cast<int32_t>(target - (at + 4));
+        std::memcpy(at, &rel, 4);
+    }
+
+    // PC = address and on to its block
+    void jumpTo(uint16_t address) {
+        movImm(REG_PC, address);
+        byte(0xFF);
+        modrm(2, 4, REG_TABLE); // jmp [rbp + address*8]
+        dword(address * 8u);
+    }
+    // PC = ecx and on to its block
+    void jumpToRcx() {
+        mov(REG_PC, RCX);
+        byte(0xFF);
+        modrm(1, 4, 4);         // jmp [rbp + rcx*8]
+        byte(0xCD);
+        byte(0);
+    }
+};
+
+// whether the comp reads its y operand (A or M), i.e. zy is clear
+bool readsY(uint8_t alu) { return !(alu & 0x08); }
+
+// leaves the ALU output in eax; y is edx for M, r12d for A. The standard
+// comps get a short translation, the rest go through the ALU bit by bit.
+// Returns whether eax may hold bits above 15.
+bool emitCompute(Emitter& e, uint8_t alu, Reg y) {
+    switch (alu & 0x3F) {
+    case 0x2A: e.zero(RAX); return false;
+    case 0x3F: e.movImm(RAX, 1); return false;
+    case 0x3A: e.movImm(RAX, 0xFFFF); return false;
+    case 0x0C: e.mov(RAX, REG_D); return false;
+    case 0x30: e.mov(RAX, y); return false;
+    case 0x0D: e.mov(RAX, REG_D); e.unary(2, RAX); return true;
+    case 0x31: e.mov(RAX, y); e.unary(2, RAX); return true;
+    case 0x0F: e.mov(RAX, REG_D); e.unary(3, RAX); return true;
+    case 0x33: e.mov(RAX, y); e.unary(3, RAX); return true;
+    case 0x1F: e.mov(RAX, REG_D); e.addImm8(0, RAX, 1); return true;
+    case 0x37: e.mov(RAX, y); e.addImm8(0, RAX, 1); return true;
+    case 0x0E: e.mov(RAX, REG_D); e.addImm8(5, RAX, 1); return true;
+    case 0x32: e.mov(RAX, y); e.addImm8(5, RAX, 1); return true;
+    case 0x02: e.mov(RAX, REG_D); e.rr(0x01, RAX, y); return true;
+    case 0x13: e.mov(RAX, REG_D); e.rr(0x29, RAX, y); return true;
+    case 0x07: e.mov(RAX, y); e.rr(0x29, RAX, REG_D); return true;
+    case 0x00: e.mov(RAX, REG_D); e.rr(0x21, RAX, y); return false;
+    case 0x15: e.mov(RAX, REG_D); e.rr(0x09, RAX, y); return false;
+    }
+    // zx nx zy ny f no, as in Cpu::compute
+    if (alu & 0x20) e.zero(RAX); else e.mov(RAX, REG_D);
+    if (alu & 0x10) e.unary(2, RAX);
+    if (alu & 0x08) e.zero(RDX); else if (y != RDX) e.mov(RDX, y);
+    if (alu & 0x04) e.unary(2, RDX);
+    e.rr((alu & 0x02) ? 0x01 : 0x21, RAX, RDX);
+    if (alu & 0x01) e.unary(2, RAX);
+    return true;
+}
+
+} // namespace
+
+#if defined(HACK_JIT)
+
+Jit::Jit(const std::vector<uint16_t>& program)
+    : ram(RAM_SIZE, 0), rom(program), halt_at(ROM_SIZE, false), table(ROM_SIZE) {
+    if (rom.size() > ROM_SIZE) {
+        throw std::runtime_error("[Error] program of " + std::to_string(rom.size()) +
+                                 " words does not fit in the 32K ROM");
+    }
+    // words past the end of the program are 0, i.e. @0
+    rom.resize(ROM_SIZE, 0);
+    for (unsigned int address = 0; address + 1 < ROM_SIZE; ++address) {
+        halt_at[address] = (rom[address] == address && rom[address + 1] == GOTO_WORD);
+    }
+
+    void* mapping = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("[Error] unable to map memory for the JIT code cache");
+    }
+    code = static_cast<uint8_t*>(mapping);
+    writeStubs();
+    flush();
+    // writable only while compile() adds a block
+    mprotect(code, CODE_SIZE, PROT_READ | PROT_EXEC);
+}
+
+Jit::~Jit() {
+    munmap(code, CODE_SIZE);
+}
+
+#else
+
+Jit::Jit(const std::vector<uint16_t>&) {
+    throw std::runtime_error("[Error] the JIT needs an x86-64 Linux host");
+}
+
+Jit::~Jit() {}
+
+#endif
+
+void Jit::reset() {
+    pc = a = d = 0;
+    is_halted = false;
+}
+
+// entry: saves the callee-saved registers, loads State and jumps to the block
+// at pc. Exits: set the reason in eax, store State back and return.
+void Jit::writeStubs() {
+    Emitter e(code);
+
+    for (uint8_t push : {0x53, 0x55}) e.byte(push);                // rbx, rbp
+    for (uint8_t push : {0x54, 0x55, 0x56, 0x57}) {                // r12-r15
+        e.byte(0x41); e.byte(push);
+    }
+    e.byte(0x57);                                                  // push rdi
+    e.byte(0x48); e.byte(0x8B); e.modrm(0, REG_RAM, RDI);          // mov rbx, [rdi]
+    e.byte(0x48); e.byte(0x8B); e.modrm(1, REG_TABLE, RDI); e.byte(8);
+    e.byte(0x4C); e.byte(0x8B); e.modrm(1, REG_BUDGET, RDI); e.byte(16);
+    e.byte(0x44); e.byte(0x8B); e.modrm(1, REG_A, RDI); e.byte(24);
+    e.byte(0x44); e.byte(0x8B); e.modrm(1, REG_D, RDI); e.byte(28);
+    e.byte(0x44); e.byte(0x8B); e.modrm(1, REG_PC, RDI); e.byte(32);
+    e.mov(RCX, REG_PC);
+    e.byte(0xFF); e.modrm(1, 4, 4); e.byte(0xCD); e.byte(0);       // jmp [rbp + rcx*8]
+
+    uint8_t* exit = e.p;
+    e.byte(0x5F);                                                  // pop rdi
+    e.byte(0x4C); e.byte(0x89); e.modrm(1, REG_BUDGET, RDI); e.byte(16);
+    e.byte(0x44); e.byte(0x89); e.modrm(1, REG_A, RDI); e.byte(24);
+    e.byte(0x44); e.byte(0x89); e.modrm(1, REG_D, RDI); e.byte(28);
+    e.byte(0x44); e.byte(0x89); e.modrm(1, REG_PC, RDI); e.byte(32);
+    for (uint8_t pop : {0x5F, 0x5E, 0x5D, 0x5C}) {                 // r15-r12
+        e.byte(0x41); e.byte(pop);
+    }
+    for (uint8_t pop : {0x5D, 0x5B}) e.byte(pop);                  // rbp, rbx
+    e.byte(0xC3);
+
+    stub_miss = e.p;
+    e.movImm(RAX, EXIT_MISS);
+    e.jmp(exit);
+    stub_budget = e.p;
+    e.movImm(RAX, EXIT_BUDGET);
+    e.jmp(exit);
+    stub_halt = e.p;
+    e.movImm(RAX, EXIT_HALT);
+    e.jmp(exit);
+
+    code_begin = e.p;
+}
+
+// drops all compiled blocks
+void Jit::flush() {
+    for (void*& entry : table) entry = stub_miss;
+    code_end = code_begin;
+}
+
+// the block starting at start; PC (r15d) is start on entry
+void Jit::compile(uint16_t start) {
+#if defined(HACK_JIT)
+    if (code + CODE_SIZE - code_end < static_cast<ptrdiff_t>(MAX_BLOCK_BYTES)) flush();
+    mprotect(code, CODE_SIZE, PROT_READ | PROT_WRITE);
+
+    Emitter e(code_end);
+    uint8_t* block = e.p;
+
+    if (halt_at[start]) {
+        // reaching a halt loop with no budget left is a plain stop, like Cpu
+        e.cmpBudget(1);
+        e.jcc(0xC, stub_budget);
+        e.jmp(stub_halt);
+    } else {
+        // the whole block is charged on entry; if it does not fit, run()
+        // steps through what is left instead
+        e.cmpBudget(0);
+        uint8_t* check = e.p - 4;
+        e.jcc(0xC, stub_budget);
+        e.subBudget(0);
+        uint8_t* charge = e.p - 4;
+
+        int known_a = -1; // A at this point when set by an @ in this block
+        uint16_t address = start;
+        uint32_t count = 0;
+        for (;;) {
+            uint16_t word = rom[address];
+            uint16_t next = (address + 1) & 0x7FFF;
+            ++count;
+
+            if (!(word & 0x8000)) {
+                e.movImm(REG_A, word);
+                known_a = word;
+            } else {
+                uint8_t alu = (word >> 6) & 0x7F;
+                unsigned int dest = (word >> 3) & 0x7;
+                unsigned int jump = word & 0x7;
+                bool value = dest != 0 || (jump != 0 && jump != 7);
+                bool uses_m = value && (alu & 0x40) && readsY(alu);
+                bool writes_m = dest & 1;
+
+                // M and the jump target are both addressed by A before the write
+                Mem m{known_a < 0, static_cast<uint32_t>(known_a & 0x7FFF)};
+                if (known_a < 0 && (uses_m || writes_m || jump != 0)) {
+                    e.mov(RCX, REG_A);
+                    e.andImm(RCX, 0x7FFF);
+                }
+                if (uses_m) e.load16(RDX, m);
+                bool wide = value && emitCompute(e, alu, uses_m ? RDX : REG_A);
+
+                if (writes_m) e.store16(m, RAX);
+                if ((dest & 6) && wide) e.zeroExtend16(RAX);
+                if (dest & 2) e.mov(REG_D, RAX);
+                if (dest & 4) e.mov(REG_A, RAX);
+
+                if (jump != 0) {
+                    uint8_t* skip = nullptr;
+                    if (jump != 7) {
+                        e.test16(RAX);
+                        skip = e.jcc(JUMP_CC[jump] ^ 1); // not taken
+                    }
+                    if (known_a < 0) e.jumpToRcx();
+                    else e.jumpTo(known_a & 0x7FFF);
+                    if (skip) {
+                        Emitter::patch(skip, e.p);
+                        e.jumpTo(next);
+                    }
+                    break;
+                }
+                if (dest & 4) known_a = -1;
+            }
+
+            if (count == MAX_BLOCK || next == 0 || halt_at[next]) {
+                e.jumpTo(next);
+                break;
+            }
+            address = next;
+        }
+        std::memcpy(check, &count, 4);
+        std::memcpy(charge, &count, 4);
+    }
+
+    code_end = e.p;
+    code_bytes += code_end - block;
+    ++blocks;
+    table[start] = block;
+    mprotect(code, CODE_SIZE, PROT_READ | PROT_EXEC);
+#else
+    (void)start;
+#endif
+}
+
+// one instruction the slow way, for the tail of a block the budget does not cover
+void Jit::step() {
+    uint16_t word = rom[pc];
+    if (!(word & 0x8000)) {
+        a = word;
+        pc = (pc + 1) & 0x7FFF;
+        return;
+    }
+    uint8_t alu = (word >> 6) & 0x7F;
+    unsigned int dest = (word >> 3) & 0x7;
+    unsigned int jump = word & 0x7;
+    uint16_t target = a;
+    uint16_t& m = ram[a & 0x7FFF];
+    uint16_t out = Cpu::compute(alu, d, a, m);
+    if (dest & 1) m = out;
+    if (dest & 4) a = out;
+    if (dest & 2) d = out;
+    unsigned int flag = (out == 0) ? 2 : (out & 0x8000) ? 4 : 1;
+    pc = (jump & flag) ? (target & 0x7FFF) : ((pc + 1) & 0x7FFF);
+}
+
+uint64_t Jit::run(uint64_t cycles) {
+    cycles = std::min<uint64_t>(cycles, std::numeric_limits<int64_t>::max());
+    State state{ram.data(), table.data(), static_cast<int64_t>(cycles), a, d, pc};
+    Entry entry = reinterpret_cast<Entry>(code);
+
+    for (;;) {
+        uint32_t reason = entry(&state);
+        if (reason == EXIT_MISS) {
+            compile(static_cast<uint16_t>(state.pc));
+            continue;
+        }
+        a = static_cast<uint16_t>(state.a);
+        d = static_cast<uint16_t>(state.d);
+        pc = static_cast<uint16_t>(state.pc);
+        if (reason == EXIT_HALT) {
+            is_halted = true;
+        } else {
+            for (; state.remaining > 0; --state.remaining) step();
+        }
+        break;
+    }
+    return cycles - static_cast<uint64_t>(state.remaining);
+}
+
+} // namespace emulator
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Cpu.h"
+
+namespace emulator {
+
+// the Hack CPU of Cpu, translated to x86-64 one basic block at a time.
+//
+// A block runs from its first instruction up to and including the first
+// jump, and is compiled the first time control reaches it. A, D and the
+// remaining cycle budget stay in host registers; PC is only materialized at
+// block exits. Every block exit (static targets and computed ones like the
+// "A=M 0;JMP" of return) jumps through a table of 32K code pointers indexed
+// by the target address, so once a block is compiled all jumps to it stay in
+// native code. Results are the same as Cpu's, cycle for cycle.
+//
+// needs an x86-64 Linux host; elsewhere the constructor throws.
+class Jit {
+public:
+    explicit Jit(const std::vector<uint16_t>& rom);
+    ~Jit();
+
+    Jit(const Jit&) = delete;
+    Jit& operator=(const Jit&) = delete;
+
+    // pc, A and D to 0 (RAM and compiled code are kept)
+    void reset();
+
+    // executes at most cycles instructions and returns how many ran; stops
+    // early at a halt loop, "(L) @L 0;JMP"
+    uint64_t run(uint64_t cycles);
+
+    bool halted() const { return is_halted; }
+
+    // blocks compiled and bytes of code generated, over all code cache flushes
+    size_t blockCount() const { return blocks; }
+    size_t codeSize() const { return code_bytes; }
+
+    uint16_t pc = 0;
+    uint16_t a = 0;
+    uint16_t d = 0;
+    std::vector<uint16_t> ram;
+
+private:
+    std::vector<uint16_t> rom;
+    std::vector<bool> halt_at;     // addresses holding the @L of a halt loop
+    std::vector<void*> table;      // code of the block at each address, or the miss exit
+
+    uint8_t* code = nullptr;       // executable mapping: stubs, then blocks
+    uint8_t* code_begin = nullptr; // first block
+    uint8_t* code_end = nullptr;   // where the next block goes
+    uint8_t* stub_miss = nullptr;
+    uint8_t* stub_budget = nullptr;
+    uint8_t* stub_halt = nullptr;
+
+    bool is_halted = false;
+    size_t blocks = 0;
+    size_t code_bytes = 0;
+
+    void writeStubs();
+    void compile(uint16_t start);
+    void flush();
+    void step();
+};
+
+} // namespace emulator
@@ -0,0 +1,66 @@
+#include "KeyScript.h"
+
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace emulator {
+
+uint16_t keyCode(const std::string& key) {
+    static const std::unordered_map<std::string, uint16_t> names {
+        {"NONE", 0}, {"SPACE", 32},
+        {"NEWLINE", 128}, {"BACKSPACE", 129}, {"LEFT", 130}, {"UP", 131},
+        {"RIGHT", 132}, {"DOWN", 133}, {"HOME", 134}, {"END", 135},
+        {"PAGEUP", 136}, {"PAGEDOWN", 137}, {"INSERT", 138}, {"DELETE", 139},
+        {"ESC", 140}, {"F1", 141}, {"F2", 142}, {"F3", 143}, {"F4", 144},
+        {"F5", 145}, {"F6", 146}, {"F7", 147}, {"F8", 148}, {"F9", 149},
+        {"F10", 150}, {"F11", 151}, {"F12", 152}
+    };
+
+    if (key.size() == 1) {
+        return static_cast<unsigned char>(key[0]);
+    }
+    std::string name(key);
+    for (char& c : name) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    auto it = names.find(name);
+    if (it != names.end()) {
+        return it->second;
+    }
+    bool digits = !key.empty();
+    for (char c : key) digits = digits && std::isdigit(static_cast<unsigned char>(c));
+    if (digits && key.size() <= 5 && std::stoul(key) <= 0xFFFF) {
+        return static_cast<uint16_t>(std::stoul(key));
+    }
+    throw std::runtime_error("[Error] unknown key: " + key);
+}
+
+std::vector<KeyEvent> readKeyScript(std::istream& in) {
+    std::vector<KeyEvent> events;
+    std::string line;
+    unsigned int line_number = 0;
+
+    while (std::getline(in, line)) {
+        ++line_number;
+        std::istringstream fields(line);
+        std::string cycle, key, extra;
+        if (!(fields >> cycle) || cycle[0] == '#') continue;
+
+        bool valid = (fields >> key) && !(fields >> extra);
+        for (char c : cycle) valid = valid && std::isdigit(static_cast<unsigned char>(c));
+        if (!valid) {
+            throw std::runtime_error("[Error] key script line " + std::to_string(line_number) +
+                                     ": expected <cycle> <key>");
+        }
+
+        KeyEvent event{std::stoull(cycle), keyCode(key)};
+        if (!events.empty() && event.cycle < events.back().cycle) {
+            throw std::runtime_error("[Error] key script line " + std::to_string(line_number) +
+                                     ": cycles must not decrease");
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+} // namespace emulator
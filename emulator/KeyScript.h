@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+
+namespace emulator {
+
+// from cycle on, KBD holds key (0 for no key)
+struct KeyEvent {
+    uint64_t cycle;
+    uint16_t key;
+};
+
+// text format, one event per line, cycles not decreasing:
+//   <cycle> <key>
+// where key is a single character (its ASCII code), a Hack key name
+// (NEWLINE, BACKSPACE, LEFT, UP, RIGHT, DOWN, HOME, END, PAGEUP, PAGEDOWN,
+// INSERT, DELETE, ESC, F1-F12, SPACE, in any case), NONE to release, or a
+// decimal code.
+// Blank lines and lines starting with # are skipped.
+std::vector<KeyEvent> readKeyScript(std::istream& in);
+
+// the Hack key code of a key as written in a script; throws for unknown names
+uint16_t keyCode(const std::string& key);
+
+} // namespace emulator
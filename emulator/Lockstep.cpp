@@ -0,0 +1,288 @@
+#include "Lockstep.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace emulator {
+
+namespace {
+
+constexpr uint16_t GOTO_WORD = 0xEA87; // 0;JMP
+constexpr unsigned int NO_PC = 0x8000;   // above every ROM address
+
+// a control bit of the ALU as a lane mask
+constexpr uint16_t ifBit(unsigned int bits, unsigned int bit) { return (bits & bit) ? 0xFFFF : 0; }
+
+} // namespace
+
+template <unsigned int Lanes>
+Lockstep<Lanes>::Lockstep(const std::vector<uint16_t>& rom)
+    : ops(ROM_SIZE), mem(static_cast<size_t>(RAM_SIZE) * Lanes, 0) {
+    if (rom.size() > ROM_SIZE) {
+        throw std::runtime_error("[Error] program of " + std::to_string(rom.size()) +
+                                 " words does not fit in the 32K ROM");
+    }
+    // words past the end of the program are 0, i.e. @0
+    std::vector<uint16_t> words(rom);
+    words.resize(ROM_SIZE, 0);
+    for (unsigned int address = 0; address < ROM_SIZE; ++address) {
+        uint16_t word = words[address];
+        Op& op = ops[address];
+        op.value = word;
+        op.compute = (word & 0x8000) != 0;
+        op.halt = !op.compute && word == address && address + 1 < ROM_SIZE && words[address + 1] == GOTO_WORD;
+        op.dest = (word >> 3) & 0x7;
+        op.jump = word & 0x7;
+        op.ym = ifBit(word, 0x1000);
+        op.zx = ~ifBit(word, 0x0800);
+        op.nx = ifBit(word, 0x0400);
+        op.zy = ~ifBit(word, 0x0200);
+        op.ny = ifBit(word, 0x0100);
+        op.f = ifBit(word, 0x0080);
+        op.no = ifBit(word, 0x0040);
+    }
+}
+
+template <unsigned int Lanes>
+void Lockstep<Lanes>::setKeys(unsigned int lane, std::vector<KeyEvent> events) {
+    keys[lane] = std::move(events);
+    next_key[lane] = 0;
+}
+
+template <unsigned int Lanes>
+std::vector<uint16_t> Lockstep<Lanes>::ram(unsigned int lane) const {
+    std::vector<uint16_t> words(RAM_SIZE);
+    for (unsigned int address = 0; address < RAM_SIZE; ++address) {
+        words[address] = mem[address * Lanes + lane];
+    }
+    return words;
+}
+
+template <unsigned int Lanes>
+double Lockstep<Lanes>::occupancy() const {
+    return issued_count ? static_cast<double>(lane_instructions) / (static_cast<double>(issued_count) * Lanes) : 0.0;
+}
+
+template <unsigned int Lanes>
+uint64_t Lockstep<Lanes>::run(uint64_t cycles) {
+    uint64_t limit[Lanes];
+    for (unsigned int l = 0; l < Lanes; ++l) {
+        limit[l] = executed[l] + std::min(cycles, std::numeric_limits<uint64_t>::max() - executed[l]);
+    }
+
+    uint64_t total = 0;
+    alignas(64) uint16_t mask[Lanes];
+    for (;;) {
+        // hand out due keys and find the lowest PC of the lanes still running
+        unsigned int low = NO_PC;
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            if (lane_halted[l] || executed[l] == limit[l]) continue;
+            for (; next_key[l] < keys[l].size() && keys[l][next_key[l]].cycle <= executed[l]; ++next_key[l]) {
+                poke(l, KBD, keys[l][next_key[l]].key);
+            }
+            low = std::min<unsigned int>(low, lane_pc[l]);
+        }
+        if (low == NO_PC) break;
+
+        // the group at that PC runs until the next lowest PC, its own next
+        // key event or cycle limit, whichever comes first
+        unsigned int count = 0, first = 0, stop = NO_PC;
+        uint64_t budget = std::numeric_limits<uint64_t>::max();
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            mask[l] = 0;
+            if (lane_halted[l] || executed[l] == limit[l]) continue;
+            if (lane_pc[l] != low) {
+                stop = std::min<unsigned int>(stop, lane_pc[l]);
+                continue;
+            }
+            mask[l] = 0xFFFF;
+            if (count++ == 0) first = l;
+            uint64_t until = limit[l];
+            if (next_key[l] < keys[l].size()) until = std::min(until, keys[l][next_key[l]].cycle);
+            budget = std::min(budget, until - executed[l]);
+        }
+
+        uint64_t steps = (count == 1) ? runLane(first, budget, static_cast<uint16_t>(stop))
+                                      : runGroup(mask, first, budget, static_cast<uint16_t>(stop));
+        total += steps * count;
+    }
+    lane_instructions += total;
+    return total;
+}
+
+template <unsigned int Lanes>
+uint64_t Lockstep<Lanes>::runGroup(const uint16_t* lanes, unsigned int first, uint64_t budget, uint16_t stop) {
+    // everything in locals, so the compiler knows the loops over the lanes
+    // don't alias RAM and can vectorize them
+    uint16_t* const ram = mem.data();
+    alignas(64) uint16_t mask[Lanes], a[Lanes], d[Lanes], m[Lanes], out[Lanes], target[Lanes], taken[Lanes];
+    std::copy(lanes, lanes + Lanes, mask);
+    std::copy(lane_a, lane_a + Lanes, a);
+    std::copy(lane_d, lane_d + Lanes, d);
+
+    uint16_t pc = lane_pc[first];
+    uint16_t spread = 0;
+    for (unsigned int l = 0; l < Lanes; ++l) spread |= (a[l] ^ a[first]) & mask[l];
+    bool a_same = !spread; // A is the same in every lane of the group
+
+    uint64_t steps = 0;
+    bool split = false;
+    while (steps < budget) {
+        const Op& op = ops[pc];
+        if (!op.compute) {
+            if (op.halt) {
+                for (unsigned int l = 0; l < Lanes; ++l) {
+                    if (mask[l]) lane_halted[l] = true;
+                }
+                break;
+            }
+            for (unsigned int l = 0; l < Lanes; ++l) a[l] = (a[l] & ~mask[l]) | (op.value & mask[l]);
+            a_same = true;
+            ++steps;
+            pc = (pc + 1) & 0x7FFF;
+            if (pc >= stop) break;
+            continue;
+        }
+
+        const unsigned int dest = op.dest, jump = op.jump;
+
+        // M: one row of RAM while A is the same, a gather otherwise
+        uint16_t* const row = ram + (a[first] & 0x7FFF) * Lanes;
+        if (op.ym || (dest & 1)) {
+            if (a_same) {
+                for (unsigned int l = 0; l < Lanes; ++l) m[l] = row[l];
+            } else {
+                for (unsigned int l = 0; l < Lanes; ++l) m[l] = ram[(a[l] & 0x7FFF) * Lanes + l];
+            }
+        }
+
+        // alu.v on all lanes
+        const uint16_t ym = op.ym, zx = op.zx, nx = op.nx, zy = op.zy, ny = op.ny, no = op.no;
+        if (op.f) {
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                uint16_t y = (m[l] & ym) | (a[l] & ~ym);
+                out[l] = static_cast<uint16_t>(((d[l] & zx) ^ nx) + ((y & zy) ^ ny)) ^ no;
+            }
+        } else {
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                uint16_t y = (m[l] & ym) | (a[l] & ~ym);
+                out[l] = (((d[l] & zx) ^ nx) & ((y & zy) ^ ny)) ^ no;
+            }
+        }
+
+        // jumps go to the A from before the write
+        if (jump) {
+            for (unsigned int l = 0; l < Lanes; ++l) target[l] = a[l] & 0x7FFF;
+        }
+        if (dest & 1) {
+            if (a_same) {
+                for (unsigned int l = 0; l < Lanes; ++l) row[l] = (out[l] & mask[l]) | (m[l] & ~mask[l]);
+            } else {
+                for (unsigned int l = 0; l < Lanes; ++l) {
+                    if (mask[l]) ram[(a[l] & 0x7FFF) * Lanes + l] = out[l];
+                }
+            }
+        }
+        if (dest & 2) {
+            for (unsigned int l = 0; l < Lanes; ++l) d[l] = (out[l] & mask[l]) | (d[l] & ~mask[l]);
+        }
+        if (dest & 4) {
+            // lanes in step usually compute the same address, like SP
+            uint16_t spread = 0;
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                a[l] = (out[l] & mask[l]) | (a[l] & ~mask[l]);
+                spread |= (out[l] ^ out[first]) & mask[l];
+            }
+            a_same = !spread;
+        }
+        ++steps;
+
+        uint16_t next = (pc + 1) & 0x7FFF;
+        if (jump == 0) {
+            pc = next;
+        } else {
+            const uint16_t jlt = ifBit(jump, 4), jeq = ifBit(jump, 2), jgt = ifBit(jump, 1);
+            uint16_t any = 0, missed = 0, spread = 0;
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                uint16_t zero = -static_cast<uint16_t>(out[l] == 0);
+                uint16_t negative = -static_cast<uint16_t>(out[l] >> 15);
+                uint16_t positive = ~(zero | negative);
+                taken[l] = ((zero & jeq) | (negative & jlt) | (positive & jgt)) & mask[l];
+                any |= taken[l];
+                missed |= mask[l] & ~taken[l];
+                spread |= (target[l] ^ target[first]) & mask[l];
+            }
+            if (!any) {
+                pc = next;
+            } else if (!missed && !spread) {
+                pc = target[first];
+            } else {
+                // the lanes branch apart
+                for (unsigned int l = 0; l < Lanes; ++l) {
+                    if (mask[l]) lane_pc[l] = taken[l] ? target[l] : next;
+                }
+                split = true;
+                break;
+            }
+        }
+        if (pc >= stop) break;
+    }
+
+    std::copy(a, a + Lanes, lane_a);
+    std::copy(d, d + Lanes, lane_d);
+    for (unsigned int l = 0; l < Lanes; ++l) {
+        if (!mask[l]) continue;
+        if (!split) lane_pc[l] = pc;
+        executed[l] += steps;
+    }
+    issued_count += steps;
+    return steps;
+}
+
+template <unsigned int Lanes>
+uint64_t Lockstep<Lanes>::runLane(unsigned int lane, uint64_t budget, uint16_t stop) {
+    uint16_t* const ram = mem.data() + lane;
+    uint16_t pc = lane_pc[lane], a = lane_a[lane], d = lane_d[lane];
+
+    uint64_t steps = 0;
+    while (steps < budget) {
+        const Op& op = ops[pc];
+        if (!op.compute) {
+            if (op.halt) {
+                lane_halted[lane] = true;
+                break;
+            }
+            a = op.value;
+            pc = (pc + 1) & 0x7FFF;
+        } else {
+            uint16_t& m = ram[(a & 0x7FFF) * Lanes];
+            uint16_t target = a & 0x7FFF;
+            uint16_t x = (d & op.zx) ^ op.nx;
+            uint16_t y = (((m & op.ym) | (a & ~op.ym)) & op.zy) ^ op.ny;
+            uint16_t out = ((static_cast<uint16_t>(x + y) & op.f) | (x & y & ~op.f)) ^ op.no;
+            if (op.dest & 1) m = out;
+            if (op.dest & 2) d = out;
+            if (op.dest & 4) a = out;
+            unsigned int flag = (out == 0) ? 2 : (out & 0x8000) ? 4 : 1;
+            pc = (op.jump & flag) ? target : ((pc + 1) & 0x7FFF);
+        }
+        ++steps;
+        if (pc >= stop) break;
+    }
+
+    lane_pc[lane] = pc;
+    lane_a[lane] = a;
+    lane_d[lane] = d;
+    executed[lane] += steps;
+    issued_count += steps;
+    scalar_count += steps;
+    return steps;
+}
+
+template class Lockstep<8>;
+template class Lockstep<16>;
+template class Lockstep<32>;
+
+} // namespace emulator
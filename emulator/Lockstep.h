@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Cpu.h"
+#include "KeyScript.h"
+
+namespace emulator {
+
+// Lanes Hack machines running the same ROM in lockstep, for fuzzing and
+// parameter sweeps where only the inputs differ. Registers and RAM are kept
+// lane by lane side by side (RAM word w of lane l at w * Lanes + l), so one
+// instruction for all lanes is a handful of loops over Lanes 16-bit values
+// that the compiler turns into SIMD code: the ALU of alu.v with its control
+// bits as masks, M loads and stores as plain vector moves while A is the same
+// in every lane, and blends to leave out lanes that are elsewhere.
+//
+// Lanes that branch apart are scheduled by lowest PC: the lanes at the lowest
+// PC run as a group until they reach another lane's PC, where they merge, or
+// branch apart again. A group of one lane runs scalar. Each lane has its own
+// cycle count and key script, so every lane ends exactly as a Cpu would.
+template <unsigned int Lanes>
+class Lockstep {
+public:
+    explicit Lockstep(const std::vector<uint16_t>& rom);
+
+    // runs every lane for at most cycles more instructions and returns the
+    // instructions run over all lanes; a lane stops early at a halt loop
+    uint64_t run(uint64_t cycles);
+
+    // key events for one lane, by that lane's instruction count
+    void setKeys(unsigned int lane, std::vector<KeyEvent> keys);
+
+    uint16_t peek(unsigned int lane, uint16_t address) const { return mem[(address & 0x7FFF) * Lanes + lane]; }
+    void poke(unsigned int lane, uint16_t address, uint16_t value) { mem[(address & 0x7FFF) * Lanes + lane] = value; }
+    std::vector<uint16_t> ram(unsigned int lane) const;
+
+    uint16_t pc(unsigned int lane) const { return lane_pc[lane]; }
+    uint16_t a(unsigned int lane) const { return lane_a[lane]; }
+    uint16_t d(unsigned int lane) const { return lane_d[lane]; }
+    bool halted(unsigned int lane) const { return lane_halted[lane]; }
+    uint64_t cycles(unsigned int lane) const { return executed[lane]; }
+
+    // instructions issued, each for a group of lanes, and how many of those
+    // were for a single lane and ran scalar
+    uint64_t issued() const { return issued_count; }
+    uint64_t scalarIssued() const { return scalar_count; }
+
+    // share of the lanes busy per issued instruction
+    double occupancy() const;
+
+private:
+    // one predecoded ROM word, with the control bits of alu.v as masks
+    struct Op {
+        uint16_t value; // A: the constant
+        bool compute;
+        bool halt;      // the @ of a halt loop
+        uint8_t dest;
+        uint8_t jump;
+        uint16_t ym, zx, nx, zy, ny, f, no;
+    };
+
+    std::vector<Op> ops;
+    std::vector<uint16_t> mem;       // RAM_SIZE * Lanes, interleaved
+
+    alignas(64) uint16_t lane_a[Lanes] = {};
+    alignas(64) uint16_t lane_d[Lanes] = {};
+    uint16_t lane_pc[Lanes] = {};
+    bool lane_halted[Lanes] = {};
+    uint64_t executed[Lanes] = {};
+
+    std::vector<KeyEvent> keys[Lanes];
+    size_t next_key[Lanes] = {};
+
+    uint64_t issued_count = 0;
+    uint64_t scalar_count = 0;
+    uint64_t lane_instructions = 0;
+
+    uint64_t runGroup(const uint16_t* lanes, unsigned int first, uint64_t budget, uint16_t stop);
+    uint64_t runLane(unsigned int lane, uint64_t budget, uint16_t stop);
+};
+
+} // namespace emulator
@@ -0,0 +1,179 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+namespace emulator {
+
+namespace {
+
+constexpr uint32_t NO_FUNCTION = std::numeric_limits<uint32_t>::max();
+
+bool isFunctionLabel(const std::string& name) {
+    return name.find('.') != std::string::npos && name.find('$') == std::string::npos;
+}
+
+bool isReturnLabel(const std::string& name) {
+    return name.find("$ret.") != std::string::npos;
+}
+
+// the translator's shared call and return routines
+bool isRuntimeLabel(const std::string& name) {
+    return name == "VM$call" || name == "VM$return";
+}
+
+} // namespace
+
+Profiler::Profiler(const std::vector<uint16_t>& rom, const assembler::SymbolFile& symbols)
+    : Cpu(rom), names{"(start)"}, function_at(ROM_SIZE, 0), return_label(ROM_SIZE, false),
+      function_entry(ROM_SIZE, false), call_routine(NO_FUNCTION) {
+    // labels are sorted, so each function runs up to the next one
+    unsigned int last_address = ROM_SIZE;
+    for (const auto& label : symbols.labels) {
+        if (label.address >= ROM_SIZE) continue;
+        if (isReturnLabel(label.name)) {
+            return_label[label.address] = true;
+        } else if (isFunctionLabel(label.name) || isRuntimeLabel(label.name)) {
+            if (!isRuntimeLabel(label.name)) function_entry[label.address] = true;
+            if (label.address == last_address) {
+                names.back() = label.name; // an empty function before this one
+            } else {
+                names.push_back(label.name);
+                last_address = label.address;
+            }
+            std::fill(function_at.begin() + label.address, function_at.end(),
+                      static_cast<uint32_t>(names.size() - 1));
+            if (label.name == "VM$call") call_routine = static_cast<uint32_t>(names.size() - 1);
+        }
+    }
+    calls.assign(names.size(), 0);
+    nodes.push_back({0, NO_FUNCTION, 0});
+    stack.push_back({0, 0});
+}
+
+uint32_t Profiler::child(uint32_t parent, uint32_t function) {
+    uint64_t key = (static_cast<uint64_t>(parent) << 32) | function;
+    auto [it, inserted] = children.emplace(key, static_cast<uint32_t>(nodes.size()));
+    if (inserted) nodes.push_back({parent, function, 0});
+    return it->second;
+}
+
+// the node for an instruction at address: the top frame, or the function
+// the code belongs to when control got there without a call
+void Profiler::settle(uint16_t address) {
+    uint32_t function = function_at[address];
+    uint32_t top = stack.back().node;
+    current = (nodes[top].function == function) ? top : child(top, function);
+}
+
+uint64_t Profiler::run(uint64_t cycles) {
+    uint64_t executed = 0;
+    while (executed < cycles) {
+        uint16_t at = pc;
+        if (nodes[current].function != function_at[at]) settle(at);
+        if (Cpu::run(1) == 0) break;
+        ++executed;
+        ++nodes[current].count;
+
+        uint16_t next = (at + 1) & 0x7FFF;
+        if (pc == next) continue;
+        if (return_label[next]) {
+            // the jump of a call, straight to the callee or through VM$call
+            uint32_t callee = function_at[pc];
+            if (callee == call_routine) {
+                call_pending = true;
+                pending_return = next;
+                continue;
+            }
+            ++calls[callee];
+            current = child(current, callee);
+            stack.push_back({current, next});
+        } else if (call_pending && function_entry[pc]) {
+            // VM$call going on to the callee
+            call_pending = false;
+            uint32_t callee = function_at[pc];
+            ++calls[callee];
+            current = child(stack.back().node, callee);
+            stack.push_back({current, pending_return});
+        } else if (return_label[pc]) {
+            // a return, to the frame that made the call
+            for (size_t i = stack.size() - 1; i > 0; --i) {
+                if (stack[i].return_address == pc) {
+                    stack.resize(i);
+                    settle(pc);
+                    break;
+                }
+            }
+        }
+    }
+    return executed;
+}
+
+std::vector<Profiler::Function> Profiler::functions() const {
+    std::vector<Function> result(names.size());
+    for (size_t f = 0; f < names.size(); ++f) {
+        result[f] = {names[f], 0, 0, calls[f]};
+    }
+    std::vector<uint32_t> seen;
+    for (const Node& node : nodes) {
+        if (node.count == 0) continue;
+        result[node.function].self += node.count;
+        // count each function on the stack once, however deep it recurses
+        seen.clear();
+        for (const Node* n = &node; n->function != NO_FUNCTION; n = &nodes[n->parent]) {
+            if (std::find(seen.begin(), seen.end(), n->function) == seen.end()) {
+                seen.push_back(n->function);
+                result[n->function].inclusive += node.count;
+            }
+        }
+    }
+    result.erase(std::remove_if(result.begin(), result.end(),
+                                [](const Function& f) { return f.inclusive == 0; }),
+                 result.end());
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Function& a, const Function& b) { return a.self > b.self; });
+    return result;
+}
+
+void Profiler::writeFolded(std::ostream& out) const {
+    std::vector<std::string> lines;
+    std::vector<const std::string*> path;
+    for (const Node& node : nodes) {
+        if (node.count == 0) continue;
+        path.clear();
+        for (const Node* n = &node; n->function != NO_FUNCTION; n = &nodes[n->parent]) {
+            path.push_back(&names[n->function]);
+        }
+        std::string line;
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            if (!line.empty()) line += ';';
+            line += **it;
+        }
+        lines.push_back(line + " " + std::to_string(node.count));
+    }
+    std::sort(lines.begin(), lines.end());
+    for (const auto& line : lines) out << line << "\n";
+}
+
+void Profiler::writeReport(std::ostream& out, size_t top) const {
+    std::vector<Function> list = functions();
+    uint64_t total = 0;
+    for (const Function& f : list) total += f.self;
+
+    auto percent = [total](uint64_t count) { return total ? 100.0 * count / total : 0.0; };
+    out << std::right << std::setw(12) << "self" << std::setw(8) << "%"
+        << std::setw(12) << "inclusive" << std::setw(8) << "%"
+        << std::setw(10) << "calls" << "  function\n";
+    for (size_t i = 0; i < list.size() && i < top; ++i) {
+        const Function& f = list[i];
+        out << std::setw(12) << f.self << std::setw(7) << std::fixed << std::setprecision(2) << percent(f.self) << "%"
+            << std::setw(12) << f.inclusive << std::setw(7) << percent(f.inclusive) << "%"
+            << std::setw(10) << f.calls << "  " << f.name << "\n";
+    }
+    if (list.size() > top) {
+        out << "  (" << list.size() - top << " more functions)\n";
+    }
+}
+
+} // namespace emulator
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+#include "Cpu.h"
+#include "../assembler/SymbolFile.h"
+
+namespace emulator {
+
+// a Cpu that attributes every instruction it runs to a function and to the
+// call stack leading to it, using the labels of the program's .sym file.
+//
+// A function is a VM function label (a name with a dot and no '$', like
+// Math.multiply) and owns the addresses up to the next one; the translator's
+// shared VM$call and VM$return routines count as functions of their own.
+// Calls are recognized by the "X$ret.N" label the VM translator puts right
+// after the jump of every call: a taken jump followed by a return label
+// pushes a frame for the function jumped to, and a jump to a return label
+// pops back to the frame that pushed it. A call that jumps to VM$call pushes
+// its frame when VM$call jumps on to a function label.
+class Profiler : public Cpu {
+public:
+    Profiler(const std::vector<uint16_t>& rom, const assembler::SymbolFile& symbols);
+
+    // like Cpu::run, but one instruction at a time
+    uint64_t run(uint64_t cycles);
+
+    struct Function {
+        std::string name;
+        uint64_t self;      // instructions executed in the function itself
+        uint64_t inclusive; // ... or with the function anywhere on the stack
+        uint64_t calls;
+    };
+
+    // functions that ran, by self count
+    std::vector<Function> functions() const;
+
+    // one "caller;...;callee count" line per call stack, for flamegraph.pl
+    void writeFolded(std::ostream& out) const;
+
+    // the top functions by self count, as a table
+    void writeReport(std::ostream& out, size_t top) const;
+
+private:
+    // a call stack: the path from the root to a node
+    struct Node {
+        uint32_t parent;
+        uint32_t function;
+        uint64_t count;
+    };
+
+    struct Frame {
+        uint32_t node;
+        uint16_t return_address;
+    };
+
+    std::vector<std::string> names;      // 0 is the code before the first function
+    std::vector<uint32_t> function_at;   // per ROM address
+    std::vector<bool> return_label;      // per ROM address
+    std::vector<bool> function_entry;    // per ROM address
+    uint32_t call_routine;               // VM$call's function, if there is one
+    bool call_pending = false;           // in VM$call, on the way to the callee
+    uint16_t pending_return = 0;         // ... which returns here
+    std::vector<uint64_t> calls;         // per function
+
+    std::vector<Node> nodes;             // 0 is the root, with no function
+    std::unordered_map<uint64_t, uint32_t> children;
+    std::vector<Frame> stack;
+    uint32_t current = 0;                // node counting the running instruction
+
+    uint32_t child(uint32_t parent, uint32_t function);
+    void settle(uint16_t address);
+};
+
+} // namespace emulator
@@ -0,0 +1,142 @@
+#include "Screen.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+
+#include "Cpu.h"
+
+namespace emulator {
+
+namespace {
+
+constexpr unsigned int ROW_BYTES = SCREEN_WIDTH / 8;
+
+// every byte with its bits in reverse order: Hack pixels run from the least
+// significant bit, image formats from the most significant one
+constexpr auto reversed = [] {
+    std::array<uint8_t, 256> table{};
+    for (unsigned int b = 0; b < 256; ++b) {
+        for (unsigned int bit = 0; bit < 8; ++bit) {
+            if (b & (1u << bit)) table[b] |= 0x80 >> bit;
+        }
+    }
+    return table;
+}();
+
+constexpr auto crc_table = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}();
+
+uint32_t crc32(const std::string& bytes) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (unsigned char b : bytes) c = crc_table[(c ^ b) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+uint32_t adler32(const std::string& bytes) {
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : bytes) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+void putBig32(std::string& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out += static_cast<char>((value >> shift) & 0xFF);
+}
+
+// one row of pixels, packed 8 to a byte with the leftmost in the top bit;
+// black pixels are 1s unless invert
+std::string packRow(const std::vector<uint16_t>& ram, unsigned int row, bool invert) {
+    std::string bytes;
+    bytes.reserve(ROW_BYTES);
+    for (unsigned int column = 0; column < SCREEN_WIDTH / 16; ++column) {
+        uint16_t word = ram[SCREEN + row * (SCREEN_WIDTH / 16) + column];
+        if (invert) word = ~word;
+        bytes += static_cast<char>(reversed[word & 0xFF]);
+        bytes += static_cast<char>(reversed[word >> 8]);
+    }
+    return bytes;
+}
+
+void writeChunk(std::ostream& out, const char* type, const std::string& data) {
+    std::string chunk(type);
+    chunk += data;
+    std::string length;
+    putBig32(length, static_cast<uint32_t>(data.size()));
+    std::string crc;
+    putBig32(crc, crc32(chunk));
+    out << length << chunk << crc;
+}
+
+// a zlib stream of stored deflate blocks
+std::string zlibStored(const std::string& data) {
+    std::string out = "\x78\x01";
+    size_t offset = 0;
+    do {
+        size_t length = std::min<size_t>(data.size() - offset, 0xFFFF);
+        bool last = offset + length == data.size();
+        out += static_cast<char>(last ? 1 : 0); // BFINAL, BTYPE 00
+        out += static_cast<char>(length & 0xFF);
+        out += static_cast<char>(length >> 8);
+        out += static_cast<char>(~length & 0xFF);
+        out += static_cast<char>((~length >> 8) & 0xFF);
+        out.append(data, offset, length);
+        offset += length;
+    } while (offset < data.size());
+    putBig32(out, adler32(data));
+    return out;
+}
+
+} // namespace
+
+void writePbm(const std::vector<uint16_t>& ram, std::ostream& out) {
+    out << "P4\n" << SCREEN_WIDTH << " " << SCREEN_HEIGHT << "\n";
+    for (unsigned int row = 0; row < SCREEN_HEIGHT; ++row) {
+        out << packRow(ram, row, false);
+    }
+}
+
+void writePng(const std::vector<uint16_t>& ram, std::ostream& out) {
+    // PNG grayscale has 1 for white, so the pixels are inverted
+    std::string header;
+    putBig32(header, SCREEN_WIDTH);
+    putBig32(header, SCREEN_HEIGHT);
+    header += std::string("\x01\x00\x00\x00\x00", 5); // 1 bit, grayscale, deflate, no filter, no interlace
+
+    std::string pixels;
+    pixels.reserve(SCREEN_HEIGHT * (ROW_BYTES + 1));
+    for (unsigned int row = 0; row < SCREEN_HEIGHT; ++row) {
+        pixels += '\0'; // filter type None
+        pixels += packRow(ram, row, true);
+    }
+
+    out << "\x89PNG\r\n\x1a\n";
+    writeChunk(out, "IHDR", header);
+    writeChunk(out, "IDAT", zlibStored(pixels));
+    writeChunk(out, "IEND", "");
+}
+
+void writeScreen(const std::vector<uint16_t>& ram, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("[Error] unable to create screen file: " + path);
+    }
+    if (std::filesystem::path(path).extension() == ".png") {
+        writePng(ram, out);
+    } else {
+        writePbm(ram, out);
+    }
+}
+
+} // namespace emulator
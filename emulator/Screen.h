@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+namespace emulator {
+
+// the 512x256 display of the screen map: row r is the 32 words from
+// SCREEN + 32*r, and the least significant bit of a word is its leftmost
+// pixel; a set bit is black.
+constexpr unsigned int SCREEN_WIDTH = 512;
+constexpr unsigned int SCREEN_HEIGHT = 256;
+
+// binary PBM (P4)
+void writePbm(const std::vector<uint16_t>& ram, std::ostream& out);
+
+// 1-bit grayscale PNG; the image data is zlib with stored (uncompressed)
+// deflate blocks, so no compression library is needed
+void writePng(const std::vector<uint16_t>& ram, std::ostream& out);
+
+// writes the screen to path as PNG for ".png", PBM otherwise
+void writeScreen(const std::vector<uint16_t>& ram, const std::string& path);
+
+} // namespace emulator
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace emulator {
+
+namespace {
+
+// a worker's share of the task indices
+struct Share {
+    std::mutex lock;
+    std::deque<size_t> tasks;
+};
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int threads) : threads(threads) {
+    if (this->threads == 0) this->threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    unsigned int workers = static_cast<unsigned int>(std::min<size_t>(threads, std::max<size_t>(count, 1)));
+    std::vector<std::unique_ptr<Share>> shares;
+    for (unsigned int w = 0; w < workers; ++w) {
+        shares.push_back(std::make_unique<Share>());
+        for (size_t i = count * w / workers; i < count * (w + 1) / workers; ++i) {
+            shares[w]->tasks.push_back(i);
+        }
+    }
+
+    std::atomic<size_t> steal_count{0};
+    std::exception_ptr failure;
+    std::mutex failure_lock;
+
+    auto next = [&](unsigned int self, size_t& index) {
+        {
+            std::lock_guard<std::mutex> guard(shares[self]->lock);
+            if (!shares[self]->tasks.empty()) {
+                index = shares[self]->tasks.front();
+                shares[self]->tasks.pop_front();
+                return true;
+            }
+        }
+        // steal from the back of the fullest share; sizes are only a hint,
+        // so re-check under its lock and look again if it emptied meanwhile
+        for (;;) {
+            unsigned int victim = self;
+            size_t most = 0;
+            for (unsigned int w = 0; w < workers; ++w) {
+                std::lock_guard<std::mutex> guard(shares[w]->lock);
+                if (shares[w]->tasks.size() > most) {
+                    most = shares[w]->tasks.size();
+                    victim = w;
+                }
+            }
+            if (most == 0) return false;
+            std::lock_guard<std::mutex> guard(shares[victim]->lock);
+            if (!shares[victim]->tasks.empty()) {
+                index = shares[victim]->tasks.back();
+                shares[victim]->tasks.pop_back();
+                ++steal_count;
+                return true;
+            }
+        }
+    };
+
+    auto work = [&](unsigned int self) {
+        size_t index;
+        while (next(self, index)) {
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(failure_lock);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int w = 1; w < workers; ++w) pool.emplace_back(work, w);
+    work(0);
+    for (auto& thread : pool) thread.join();
+
+    stolen = steal_count;
+    if (failure) std::rethrow_exception(failure);
+}
+
+} // namespace emulator
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace emulator {
+
+// runs a batch of independent tasks on a fixed number of threads with work
+// stealing. Each worker starts with its own contiguous share of the task
+// indices and takes them from the front; a worker that runs out steals from
+// the back of the fullest other share, so uneven task lengths still keep
+// every thread busy until the batch is done.
+class ThreadPool {
+public:
+    // threads == 0 uses one per hardware thread
+    explicit ThreadPool(unsigned int threads = 0);
+
+    // calls task(i) for every i in [0, count) and returns when all are done;
+    // task must be safe to call concurrently
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    unsigned int size() const { return threads; }
+
+    // tasks taken from another worker's share in the last run
+    size_t steals() const { return stolen; }
+
+private:
+    unsigned int threads;
+    size_t stolen = 0;
+};
+
+} // namespace emulator
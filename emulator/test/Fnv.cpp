@@ -0,0 +1,44 @@
+// Fnv.cpp
+// prints the hashes BatchRunner reports for a RAM dump from the emulator,
+// computed on their own so the suite can check BatchRunner against them
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <vector>
+
+#include "../../assembler/RomImage.h"
+
+namespace {
+
+// FNV-1a 64 over the low and then the high byte of every word
+uint64_t fnv1a(const std::vector<uint16_t>& words, size_t first, size_t count) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = first; i < first + count && i < words.size(); ++i) {
+        for (int byte : {words[i] & 0xFF, words[i] >> 8}) {
+            hash ^= static_cast<uint64_t>(byte);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <ram dump>\n"
+                  << "  prints ram:<hash> and screen:<hash> as BatchRunner computes them\n";
+        return 1;
+    }
+    try {
+        std::vector<uint16_t> ram = assembler::readRom(argv[1]);
+        std::cout << std::hex << std::setfill('0')
+                  << "ram:" << std::setw(16) << fnv1a(ram, 0, 32768) << "\n"
+                  << "screen:" << std::setw(16) << fnv1a(ram, 16384, 8192) << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,353 @@
+// every comp on D = 21845, A = 13107, M = 4660, then every jump on -1, 0 and 1,
+// each result stored from RAM[100] on; alu.expected lists them
+@4660
+D=A
+@13107
+M=D
+@21845
+D=A
+@13107
+D=0
+@100
+M=D
+@21845
+D=A
+@13107
+D=1
+@101
+M=D
+@21845
+D=A
+@13107
+D=-1
+@102
+M=D
+@21845
+D=A
+@13107
+D=D
+@103
+M=D
+@21845
+D=A
+@13107
+D=A
+@104
+M=D
+@21845
+D=A
+@13107
+D=M
+@105
+M=D
+@21845
+D=A
+@13107
+D=!D
+@106
+M=D
+@21845
+D=A
+@13107
+D=!A
+@107
+M=D
+@21845
+D=A
+@13107
+D=!M
+@108
+M=D
+@21845
+D=A
+@13107
+D=-D
+@109
+M=D
+@21845
+D=A
+@13107
+D=-A
+@110
+M=D
+@21845
+D=A
+@13107
+D=-M
+@111
+M=D
+@21845
+D=A
+@13107
+D=D+1
+@112
+M=D
+@21845
+D=A
+@13107
+D=A+1
+@113
+M=D
+@21845
+D=A
+@13107
+D=M+1
+@114
+M=D
+@21845
+D=A
+@13107
+D=D-1
+@115
+M=D
+@21845
+D=A
+@13107
+D=A-1
+@116
+M=D
+@21845
+D=A
+@13107
+D=M-1
+@117
+M=D
+@21845
+D=A
+@13107
+D=D+A
+@118
+M=D
+@21845
+D=A
+@13107
+D=D+M
+@119
+M=D
+@21845
+D=A
+@13107
+D=D-A
+@120
+M=D
+@21845
+D=A
+@13107
+D=D-M
+@121
+M=D
+@21845
+D=A
+@13107
+D=A-D
+@122
+M=D
+@21845
+D=A
+@13107
+D=M-D
+@123
+M=D
+@21845
+D=A
+@13107
+D=D&A
+@124
+M=D
+@21845
+D=A
+@13107
+D=D&M
+@125
+M=D
+@21845
+D=A
+@13107
+D=D|A
+@126
+M=D
+@21845
+D=A
+@13107
+D=D|M
+@127
+M=D
+@21845
+D=A
+@13107
+AMD=D+1
+@13107
+D=M
+@128
+M=D
+@129
+M=1
+D=-1
+@TAKEN0
+D;JGT
+@129
+M=0
+(TAKEN0)
+@130
+M=1
+D=0
+@TAKEN1
+D;JGT
+@130
+M=0
+(TAKEN1)
+@131
+M=1
+D=1
+@TAKEN2
+D;JGT
+@131
+M=0
+(TAKEN2)
+@132
+M=1
+D=-1
+@TAKEN3
+D;JEQ
+@132
+M=0
+(TAKEN3)
+@133
+M=1
+D=0
+@TAKEN4
+D;JEQ
+@133
+M=0
+(TAKEN4)
+@134
+M=1
+D=1
+@TAKEN5
+D;JEQ
+@134
+M=0
+(TAKEN5)
+@135
+M=1
+D=-1
+@TAKEN6
+D;JGE
+@135
+M=0
+(TAKEN6)
+@136
+M=1
+D=0
+@TAKEN7
+D;JGE
+@136
+M=0
+(TAKEN7)
+@137
+M=1
+D=1
+@TAKEN8
+D;JGE
+@137
+M=0
+(TAKEN8)
+@138
+M=1
+D=-1
+@TAKEN9
+D;JLT
+@138
+M=0
+(TAKEN9)
+@139
+M=1
+D=0
+@TAKEN10
+D;JLT
+@139
+M=0
+(TAKEN10)
+@140
+M=1
+D=1
+@TAKEN11
+D;JLT
+@140
+M=0
+(TAKEN11)
+@141
+M=1
+D=-1
+@TAKEN12
+D;JNE
+@141
+M=0
+(TAKEN12)
+@142
+M=1
+D=0
+@TAKEN13
+D;JNE
+@142
+M=0
+(TAKEN13)
+@143
+M=1
+D=1
+@TAKEN14
+D;JNE
+@143
+M=0
+(TAKEN14)
+@144
+M=1
+D=-1
+@TAKEN15
+D;JLE
+@144
+M=0
+(TAKEN15)
+@145
+M=1
+D=0
+@TAKEN16
+D;JLE
+@145
+M=0
+(TAKEN16)
+@146
+M=1
+D=1
+@TAKEN17
+D;JLE
+@146
+M=0
+(TAKEN17)
+@147
+M=1
+D=-1
+@TAKEN18
+D;JMP
+@147
+M=0
+(TAKEN18)
+@148
+M=1
+D=0
+@TAKEN19
+D;JMP
+@148
+M=0
+(TAKEN19)
+@149
+M=1
+D=1
+@TAKEN20
+D;JMP
+@149
+M=0
+(TAKEN20)
+(END)
+@END
+0;JMP
@@ -0,0 +1,15 @@
+// copies KBD to the first screen word and to RAM[0] until Q (81) is pressed
+(LOOP)
+@KBD
+D=M
+@SCREEN
+M=D
+@0
+M=D
+@81
+D=D-A
+@LOOP
+D;JNE
+(END)
+@END
+0;JMP
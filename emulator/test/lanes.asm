@@ -0,0 +1,36 @@
+// RAM[0] = n - (n - 1) + (n - 2) - ... for n = RAM[100], adding odd and
+// subtracting even terms, so lanes with different n branch apart
+@R0
+M=0
+@100
+D=M
+@R1
+M=D
+(LOOP)
+@R1
+D=M
+@END
+D;JLE
+@1
+D=D&A
+@EVEN
+D;JEQ
+@R1
+D=M
+@R0
+M=D+M
+@NEXT
+0;JMP
+(EVEN)
+@R1
+D=M
+@R0
+M=M-D
+(NEXT)
+@R1
+M=M-1
+@LOOP
+0;JMP
+(END)
+@END
+0;JMP
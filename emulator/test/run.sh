@@ -0,0 +1,138 @@
+#!/usr/bin/env bash
+# emulator checks: hand-written programs run to the results and instruction
+# counts worked out by hand, every comp and jump computes what the Hack spec
+# says, a compiled program leaves the values in its expected.txt, and the
+# JIT agrees with the interpreter, also on replayed keys and screen captures,
+# the profiler follows every call, BatchRunner hashes RAM and screen, and
+# lockstep lanes compute what one machine does
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$WORK"
+
+for program in sum alu; do
+    cp "$REPO/emulator/test/$program.asm" .
+    "$BIN/Assembler" "$program.asm" > /dev/null
+done
+
+run sum.hack 100000 sum.ram.hack
+grep -q "Halted after 1010 instructions at pc 16" emulator.log || fail "sum: $(head -1 emulator.log)"
+[[ "$(ram sum.ram.hack 0)" == 5050 ]] || fail "sum: RAM[0] is $(ram sum.ram.hack 0)"
+ok "sum halts after 1010 instructions with 5050"
+
+run alu.hack 100000 alu.ram.hack
+ram alu.ram.hack 100 "$(wc -l < "$REPO/emulator/test/alu.expected")" > alu.txt
+same "every comp and jump" "$REPO/emulator/test/alu.expected" alu.txt
+
+expected="$REPO/compiler/test/Features/expected.txt"
+(cd "$REPO" && hackc compiler/test/Features -o "$WORK/features.hack" --incremental -O)
+run features.hack 20000000 features.ram.hack
+ram features.ram.hack 8000 "$(wc -l < "$expected")" > features.txt
+same "Features" "$expected" features.txt
+
+# --check runs the JIT and the interpreter side by side; the odd cycle limits
+# stop both in the middle of a block
+(cd "$REPO" && hackc compiler/test_programs/Pong -o "$WORK/pong.hack" --incremental -O)
+if [[ "$(uname -m)" == x86_64 ]]; then
+    for job in "sum.hack 100000" "alu.hack 100000" "features.hack 20000000" "features.hack 1234567" \
+               "pong.hack 30000001"; do
+        set -- $job
+        "$BIN/Emulator" "$1" --max-cycles "$2" --check > check.log 2>&1 || { cat check.log >&2; fail "--check $job"; }
+        grep -q "JIT and interpreter agree" check.log || fail "--check $job: $(tail -1 check.log)"
+        ok "JIT agrees with the interpreter: $job"
+    done
+    run features.hack 20000000 features.jit.ram.hack --jit
+    same "--jit leaves the same RAM" features.ram.hack features.jit.ram.hack
+fi
+
+# --keys and --screen: keys.asm copies KBD to the first screen word, so each
+# capture shows the key held at that cycle in its first pixels
+cp "$REPO/emulator/test/keys.asm" "$REPO/emulator/test/keys.txt" .
+"$BIN/Assembler" keys.asm > /dev/null
+# pbm <first byte>: a screen capture with only the first 8 pixels set
+pbm() {
+    printf 'P4\n512 256\n'
+    printf "\\x$1"
+    head -c 16383 /dev/zero
+}
+pbm 00 > blank.pbm
+pbm 82 > A.pbm # 'A' = 65: pixels 0 and 6
+pbm 8a > Q.pbm # 'Q' = 81: pixels 0, 4 and 6
+modes=("")
+[[ "$(uname -m)" == x86_64 ]] && modes+=(--jit)
+for mode in "${modes[@]}"; do
+    run keys.hack 100000 "keys$mode.ram.hack" $mode --keys keys.txt --screen 500 "500$mode.pbm" \
+        --screen 1500 "1500$mode.pbm" --screen 2500 "2500$mode.pbm" --screen end "end$mode.pbm" \
+        --screen end "end$mode.png"
+    grep -q "Halted after 3010 instructions" emulator.log || fail "keys $mode: $(head -1 emulator.log)"
+    same "screen before the first key ${mode:-(interpreter)}" blank.pbm "500$mode.pbm"
+    same "screen while A is held ${mode:-(interpreter)}" A.pbm "1500$mode.pbm"
+    same "screen after A is released ${mode:-(interpreter)}" blank.pbm "2500$mode.pbm"
+    same "screen after Q ${mode:-(interpreter)}" Q.pbm "end$mode.pbm"
+    [[ "$(head -c 24 "end$mode.png" | od -An -tx1 | tr -d ' \n')" == \
+       89504e470d0a1a0a0000000d4948445200000200000001* ]] || fail "end$mode.png is not a 512x256 PNG"
+    ok "PNG capture ${mode:-(interpreter)}"
+done
+if (( ${#modes[@]} > 1 )); then
+    same "--jit replays keys like the interpreter" keys.ram.hack keys--jit.ram.hack
+fi
+
+# --profile counts the calls Features makes, and the folded stacks add up to
+# every instruction run
+(cd "$REPO" && hackc compiler/test/Features -o "$WORK/profile/o.hack" --incremental -O -g)
+"$BIN/Emulator" profile/o.hack --max-cycles 20000000 --profile profile/o.sym --folded folded.txt > profile.log ||
+    { cat profile.log >&2; fail "--profile"; }
+for expected in "1 Main.main" "34 Main.put" "7 Main.factorial" "1 Main.sum" "2 Point.new" "1 Point.distance"; do
+    set -- $expected
+    calls="$(awk -v f="$2" '$NF == f { print $(NF - 1) }' profile.log)"
+    [[ "$calls" == "$1" ]] || fail "--profile: $2 called ${calls:-no} times, not $1"
+done
+ok "--profile call counts"
+[[ "$(awk '{ n += $NF } END { print n }' folded.txt)" == 20000000 ]] || fail "--folded counts do not add up"
+seven="Sys.init;Main.main$(printf ';Main.factorial%.0s' 1 2 3 4 5 6 7)"
+grep -q "^$seven " folded.txt || fail "--folded has no stack seven factorials deep"
+! grep -q "^$seven;Main.factorial" folded.txt || fail "--folded has a stack eight factorials deep"
+ok "--folded stacks"
+
+# BatchRunner: the hashes match ones computed from the emulator's RAM dumps,
+# and a wrong hash or a missing image fails the batch
+"${CXX:-g++}" -std=c++17 -O2 -o fnv "$REPO/emulator/test/Fnv.cpp" "$REPO/assembler/RomImage.cpp"
+: > manifest.txt
+for job in "sum.hack - 100000 ram" "alu.hack - 100000 ram" "keys.hack keys.txt 100000 screen" \
+           "features.hack - 20000000 ram" "pong.hack - 20000000 screen"; do
+    set -- $job
+    keys=()
+    [[ "$2" == - ]] || keys=(--keys "$2")
+    run "$1" "$3" "$1.$3.bin" "${keys[@]}"
+    echo "$1 $2 $3 $(./fnv "$1.$3.bin" | grep "^$4:")" >> manifest.txt
+done
+"$BIN/BatchRunner" manifest.txt -j 3 -o batch.json > /dev/null 2>&1 || { cat batch.json >&2; fail "BatchRunner"; }
+[[ "$(grep -c '"status": "pass"' batch.json)" == 5 ]] || fail "BatchRunner: not every job passed"
+ok "BatchRunner hashes match the emulator's RAM"
+
+sed '1s/ram:[0-9a-f]*/ram:0123456789abcdef/' manifest.txt > wrong.txt
+echo "missing.hack - 1000 -" >> wrong.txt
+if "$BIN/BatchRunner" wrong.txt -o wrong.json > /dev/null 2>&1; then
+    fail "BatchRunner passed a wrong hash"
+fi
+grep -q '"status": "fail"' wrong.json && grep -q '"status": "error"' wrong.json ||
+    fail "BatchRunner did not report the wrong hash and the missing image"
+ok "BatchRunner fails a wrong hash and a missing image"
+
+# --lanes: lanes.asm branches apart on the swept n, so each lane's result is
+# worked out here, and --check replays every lane on the interpreter
+cp "$REPO/emulator/test/lanes.asm" .
+"$BIN/Assembler" lanes.asm > /dev/null
+"$BIN/Emulator" lanes.hack --lanes 16 --sweep 100 1 3 --check > lanes.log 2>&1 || { cat lanes.log >&2; fail "--lanes"; }
+grep -q "All 16 lanes agree with the interpreter" lanes.log || fail "--lanes --check: $(tail -1 lanes.log)"
+for lane in $(seq 0 15); do
+    n=$((1 + 3 * lane))
+    result=$(( (n % 2 ? (n + 1) / 2 : -n / 2) & 0xFFFF ))
+    grep -q "lane *$lane: halted .*, SP $result$" lanes.log || fail "lane $lane (n = $n) did not end with $result"
+done
+ok "16 divergent lanes compute their own results and agree with the interpreter"
+for lanes in 8 32; do
+    "$BIN/Emulator" features.hack --lanes "$lanes" --max-cycles 2000000 --check > lanes.log 2>&1 ||
+        { cat lanes.log >&2; fail "--lanes $lanes"; }
+    grep -q "All $lanes lanes agree with the interpreter" lanes.log || fail "--lanes $lanes: $(tail -1 lanes.log)"
+    ok "$lanes lanes of Features agree with the interpreter"
+done
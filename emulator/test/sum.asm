@@ -0,0 +1,21 @@
+// RAM[0] = 1 + 2 + ... + 100, in exactly 1010 instructions
+@0
+M=0
+@100
+D=A
+@1
+M=D
+(LOOP)
+@1
+D=M
+@END
+D;JEQ
+@0
+M=D+M
+@1
+M=M-1
+@LOOP
+0;JMP
+(END)
+@END
+0;JMP
@@ -0,0 +1,145 @@
+// cosim.cpp
+// co-simulates the verilated cpu.v against emulator::Cpu on a ROM image.
+// every cycle the testbench fetches the instruction at the RTL's PC, feeds
+// inM from its own RAM and checks PC, A, D, writeM and addressM (and outM on
+// writes) against the software model, stopping at the first divergence.
+// built by cosim.sh, which defines COSIM so that cpu.v brings its A and D
+// registers out as ports.
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <exception>
+
+#include "Vcpu.h"
+#include "verilated.h"
+
+#include "../emulator/Cpu.h"
+#include "../assembler/RomImage.h"
+
+namespace {
+
+struct Signals {
+    unsigned int pc, a, d, write_m, address_m, out_m;
+};
+
+std::string hex(unsigned int value) {
+    std::ostringstream out;
+    out << "0x" << std::hex << std::setw(4) << std::setfill('0') << value;
+    return out.str();
+}
+
+void report(uint64_t cycle, uint16_t pc, uint16_t instruction, const char* signal,
+            unsigned int rtl, unsigned int model) {
+    std::cerr << "[Error] divergence at cycle " << cycle << ", pc " << pc
+              << " (instruction " << hex(instruction) << "): " << signal
+              << " is " << hex(rtl) << " in cpu.v, " << hex(model) << " in the model\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string image_path;
+    uint64_t max_cycles = 100000000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max-cycles" && i + 1 < argc) {
+            max_cycles = std::stoull(argv[++i]);
+        } else if (image_path.empty() && !arg.empty() && arg[0] != '-') {
+            image_path = arg;
+        } else {
+            image_path.clear();
+            break;
+        }
+    }
+    if (image_path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <image.hack|.bin|.hex> [--max-cycles <n>]\n"
+                  << "  runs cpu.v and the emulator's CPU in lockstep until the program halts,\n"
+                  << "  max-cycles (default: 100000000) have run, or they diverge\n";
+        return 1;
+    }
+
+    try {
+        std::vector<uint16_t> rom = assembler::readRom(image_path);
+        emulator::Cpu model(rom);
+        rom.resize(emulator::ROM_SIZE, 0);
+        std::vector<uint16_t> ram(emulator::RAM_SIZE, 0);
+
+        auto context = std::make_unique<VerilatedContext>();
+        auto top = std::make_unique<Vcpu>(context.get());
+
+        // hold reset over one clock edge
+        top->reset = 1;
+        top->clk = 0;
+        top->instruction = 0;
+        top->inM = 0;
+        top->eval();
+        top->clk = 1;
+        top->eval();
+        top->reset = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t cycle = 0;
+        bool halted = false;
+        for (; cycle < max_cycles; ++cycle) {
+            // fetch, then settle inM for the address A puts out
+            uint16_t pc = top->pc & 0x7FFF;
+            uint16_t instruction = rom[pc];
+            top->clk = 0;
+            top->instruction = instruction;
+            top->eval();
+            unsigned int address = top->addressM;
+            top->inM = ram[address];
+            top->eval();
+            Signals rtl{pc, 0, 0, top->writeM, address, top->outM};
+
+            // what the model does with the same instruction
+            Signals expected{model.pc, 0, 0, (instruction & 0x8008) == 0x8008,
+                             static_cast<unsigned int>(model.a & 0x7FFF), 0};
+            if (model.run(1) == 0) {
+                halted = true;
+                break;
+            }
+
+            // clock edge: registers and PC update, RAM takes the write
+            top->clk = 1;
+            top->eval();
+            if (rtl.write_m) ram[address] = static_cast<uint16_t>(rtl.out_m);
+            rtl.a = top->a_reg;
+            rtl.d = top->d_reg;
+            expected.out_m = model.ram[expected.address_m];
+
+            bool same = true;
+            auto check = [&](const char* signal, unsigned int a, unsigned int b) {
+                if (same && a != b) {
+                    report(cycle, pc, instruction, signal, a, b);
+                    same = false;
+                }
+            };
+            check("PC", rtl.pc, expected.pc);
+            check("writeM", rtl.write_m, expected.write_m);
+            check("addressM", rtl.address_m, expected.address_m);
+            if (rtl.write_m) check("outM", rtl.out_m, expected.out_m);
+            check("A", rtl.a, model.a);
+            check("D", rtl.d, model.d);
+            check("PC after", top->pc & 0x7FFF, model.pc);
+            if (!same) return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "cpu.v and the model agree over " << cycle << " cycles"
+                  << (halted ? " (halted)" : "") << "\n"
+                  << "  " << std::fixed << std::setprecision(2) << seconds * 1000 << " ms, "
+                  << (seconds > 0 ? cycle / seconds / 1e6 : 0.0) << " million cycles per second\n";
+        top->final();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
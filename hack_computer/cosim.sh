@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+# builds the Verilator co-simulation of cpu.v (cosim.cpp) and runs it on a
+# ROM image: ./hack_computer/cosim.sh build/o.hack [--max-cycles <n>]
+set -euo pipefail
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+REPO="$(dirname "$HERE")"
+OBJ_DIR="$HERE/obj_cosim"
+
+if ! command -v verilator >/dev/null 2>&1; then
+    echo "[Error] verilator not found (install it, e.g. apt install verilator)" >&2
+    exit 1
+fi
+
+# COSIM adds the A and D registers to cpu's ports; lint warnings stop the
+# build like errors do
+verilator --cc --exe --build -j 0 -O3 -DCOSIM \
+    --top-module cpu -Mdir "$OBJ_DIR" \
+    -CFLAGS "-std=c++17 -O2" \
+    "$HERE/cpu.v" "$HERE/alu.v" "$HERE/register.v" "$HERE/program_counter.v" \
+    "$HERE/cosim.cpp" "$REPO/emulator/Cpu.cpp" "$REPO/assembler/RomImage.cpp" \
+    > "$OBJ_DIR.log" 2>&1 || { cat "$OBJ_DIR.log" >&2; exit 1; }
+
+"$OBJ_DIR/Vcpu" "$@"
@@ -13,6 +13,12 @@ module cpu #(
 	output wire             writeM,
 	output wire [WIDTH-2:0] addressM,
 	output wire [WIDTH-1:0] pc
+`ifdef COSIM
+	,
+	// the A and D registers, for the co-simulation (cosim.sh defines COSIM)
+	output wire [WIDTH-1:0] a_reg,
+	output wire [WIDTH-1:0] d_reg
+`endif
 );	
 	// instruction splitter:
 	// note this assumes WIDTH==16:
@@ -30,7 +36,7 @@ module cpu #(
 	wire [WIDTH-1:0] a_reg_out;
 	wire a_reg_load = ~instruction_type | d[2];
 	wire [WIDTH-1:0] d_reg_out;
-	wire d_reg_load = d[1];
+	wire d_reg_load = d[1] & instruction_type; // d bits of an A instruction are data
 	wire [WIDTH-1:0] alu_y = a ? inM : a_reg_out;
 	wire alu_zero;
 	wire alu_negative;
@@ -99,4 +105,8 @@ module cpu #(
 	assign addressM = a_reg_out[WIDTH-2:0];
 	assign writeM = d[0] & instruction_type;
 	assign outM = alu_out;
+`ifdef COSIM
+	assign a_reg = a_reg_out;
+	assign d_reg = d_reg_out;
+`endif
 endmodule
@@ -0,0 +1,95 @@
+// self-checking testbench for cpu.v: runs a seven instruction program and
+// checks the PC of every cycle and the one memory write, then prints
+// "cpu_tb: passed" or each failure. Run by hack_computer/test/run.sh.
+// - a PC that counts on from A instead of from itself jumps to 8 after
+//   D=A, where A is 7
+// - a D register that loads on A-instructions (bit 4 is a C-instruction's
+//   D bit, and it is set in @16 and @17) takes D&A = 0 at @17, so M=D
+//   writes 0
+`timescale 1ns/1ps
+module cpu_tb;
+	reg clk = 1'b0;
+	reg reset = 1'b0;
+	wire [15:0] instruction;
+	wire [15:0] inM = 16'd0; // the program never reads M
+	wire [15:0] outM;
+	wire        writeM;
+	wire [14:0] addressM;
+	wire [15:0] pc;
+
+	cpu dut(
+		// input
+		.clk(clk),
+		.instruction(instruction),
+		.inM(inM),
+		.reset(reset),
+		// output
+		.outM(outM),
+		.writeM(writeM),
+		.addressM(addressM),
+		.pc(pc)
+	);
+
+	reg [15:0] rom [0:7];
+	reg [15:0] expected_pc [0:9]; // the PC in each cycle
+	reg [3:0] cycle;
+	integer failures;
+	integer writes;
+
+	assign instruction = rom[pc[2:0]];
+
+	initial begin
+		rom[0] = 16'b0000000000000111; // @7
+		rom[1] = 16'b1110110000010000; // D=A
+		rom[2] = 16'b0000000000010000; // @16
+		rom[3] = 16'b0000000000010001; // @17
+		rom[4] = 16'b1110001100001000; // M=D
+		rom[5] = 16'b0000000000000101; // (HALT) @HALT
+		rom[6] = 16'b1110101010000111; // 0;JMP
+		rom[7] = 16'b0000000000000000;
+		expected_pc[0] = 16'd0;
+		expected_pc[1] = 16'd1;
+		expected_pc[2] = 16'd2;
+		expected_pc[3] = 16'd3;
+		expected_pc[4] = 16'd4;
+		expected_pc[5] = 16'd5;
+		expected_pc[6] = 16'd6;
+		expected_pc[7] = 16'd5;
+		expected_pc[8] = 16'd6;
+		expected_pc[9] = 16'd5;
+		failures = 0;
+		writes = 0;
+
+		// asynchronous reset, then a clock edge every 10ns; the outputs
+		// are checked while the clock is low
+		#1 reset = 1'b1;
+		#1 reset = 1'b0;
+		for (cycle = 4'd0; cycle < 4'd10; cycle = cycle + 4'd1) begin
+			#4;
+			if (pc !== expected_pc[cycle]) begin
+				$display("cpu_tb: cycle %0d: pc is %0d, not %0d", cycle, pc, expected_pc[cycle]);
+				failures = failures + 1;
+			end
+			if (writeM) begin
+				writes = writes + 1;
+				if (pc !== 16'd4 || addressM !== 15'd17 || outM !== 16'd7) begin
+					$display("cpu_tb: cycle %0d: pc %0d writes %0d to %0d, not 7 to 17 at pc 4",
+						cycle, pc, outM, addressM);
+					failures = failures + 1;
+				end
+			end
+			#1 clk = 1'b1;
+			#5 clk = 1'b0;
+		end
+
+		if (writes != 1) begin
+			$display("cpu_tb: %0d memory writes, not 1", writes);
+			failures = failures + 1;
+		end
+		if (failures == 0)
+			$display("cpu_tb: passed");
+		else
+			$display("cpu_tb: %0d failures", failures);
+		$finish;
+	end
+endmodule
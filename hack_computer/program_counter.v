@@ -21,7 +21,7 @@ module program_counter #(
 			if (load == 1) 
 				out <= in;
 			else if (inc == 1)
-				out <= in + 1;
+				out <= out + 1;
 			else 
 				out <= out;
 		end
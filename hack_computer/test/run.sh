@@ -0,0 +1,39 @@
+#!/usr/bin/env bash
+# hack_computer checks: cpu_tb.v passes on cpu.v, under Icarus Verilog or
+# Verilator, and with Verilator cosim.sh runs Pong in lockstep with the
+# emulator. A missing simulator skips its checks, unless COSIM_REQUIRED=1,
+# which makes it a failure.
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$REPO/hack_computer"
+
+# missing <what>: skips what, or fails with COSIM_REQUIRED=1
+missing() {
+    [[ "${COSIM_REQUIRED:-0}" == 1 ]] && fail "$1: no simulator, and COSIM_REQUIRED=1"
+    ok "$1 skipped, no simulator installed"
+}
+
+rtl=(cpu.v alu.v register.v program_counter.v)
+if command -v iverilog > /dev/null; then
+    iverilog -o "$WORK/cpu_tb" cpu_tb.v "${rtl[@]}"
+    vvp -n "$WORK/cpu_tb" > "$WORK/cpu_tb.log"
+elif command -v verilator > /dev/null; then
+    verilator --binary -j 0 --top-module cpu_tb -Mdir "$WORK/cpu_tb" cpu_tb.v "${rtl[@]}" \
+        > "$WORK/cpu_tb.build.log" 2>&1 || { cat "$WORK/cpu_tb.build.log" >&2; fail "cpu_tb.v does not build"; }
+    "$WORK/cpu_tb/Vcpu_tb" > "$WORK/cpu_tb.log"
+fi
+if [[ -f "$WORK/cpu_tb.log" ]]; then
+    grep -q '^cpu_tb: passed' "$WORK/cpu_tb.log" || { cat "$WORK/cpu_tb.log" >&2; fail "cpu_tb.v"; }
+    ok "cpu_tb.v passes"
+else
+    missing "cpu_tb.v"
+fi
+
+if command -v verilator > /dev/null; then
+    (cd "$REPO" && hackc compiler/test_programs/Pong -o "$WORK/pong.hack" --incremental -O)
+    ./cosim.sh "$WORK/pong.hack" --max-cycles 30000000 > "$WORK/cosim.log" 2>&1 ||
+        { cat "$WORK/cosim.log" >&2; fail "co-simulation of Pong"; }
+    ok "Pong: $(head -1 "$WORK/cosim.log")"
+else
+    missing "co-simulation of Pong"
+fi
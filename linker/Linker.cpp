@@ -0,0 +1,91 @@
+// Linker.cpp
+// links relocatable Hack objects (.hobj, from `Assembler -c`) into Hack machine code.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <exception>
+
+#include "ObjectLinker.h"
+#include "../assembler/HackAssembler.h"
+#include "../assembler/SymbolFile.h"
+
+int main(int argc, char* argv[]) {
+    std::filesystem::path output_path;
+    bool drop_unreferenced = true;
+    bool write_symbols = false;
+    assembler::RomFormat format = assembler::RomFormat::ASCII;
+    std::vector<std::string> object_files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (arg == "--keep-all") {
+            drop_unreferenced = false;
+        } else if (arg == "-g") {
+            write_symbols = true;
+        } else if (arg.rfind("--format=", 0) == 0) {
+            if (!assembler::parseRomFormat(arg.substr(9), format)) {
+                object_files.clear();
+                break;
+            }
+        } else {
+            object_files.push_back(arg);
+        }
+    }
+
+    if (object_files.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [-o <out.hack>] [--keep-all] [-g] [--format=ascii|bin|hex] <entry.hobj> [<file.hobj> ...]\n"
+                  << "  execution starts at the first object; unreferenced sections are dropped\n"
+                  << "  unless --keep-all is given. see the assembler for the output formats\n"
+                  << "  -g also writes <out>.sym with the linked label and variable addresses\n";
+        return 1;
+    }
+    if (output_path.empty()) {
+        output_path = object_files.front();
+        output_path.replace_extension(assembler::romExtension(format));
+    }
+
+    linker::ObjectLinker objectLinker;
+    std::vector<uint16_t> image;
+    assembler::SymbolFile symbols;
+    try {
+        for (const auto& object_file : object_files) {
+            std::ifstream in(object_file);
+            if (!in.is_open()) {
+                std::cerr << "[Error] Unable to open object file: " << object_file << "\n";
+                return 1;
+            }
+            objectLinker.addObject(assembler::ObjectFile::read(in), object_file);
+        }
+        image = objectLinker.link(drop_unreferenced, write_symbols ? &symbols : nullptr);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::ofstream hack_file(output_path, std::ios::binary);
+    if (!hack_file.is_open()) {
+        std::cerr << "[Error] Unable to create output file: " << output_path.string() << "\n";
+        return 1;
+    }
+    assembler::writeRom(image, format, hack_file);
+    hack_file.close();
+
+    if (write_symbols) {
+        std::ofstream sym_file(std::filesystem::path(output_path).replace_extension(".sym"));
+        if (!sym_file.is_open()) {
+            std::cerr << "[Error] Unable to create symbol file for: " << output_path.string() << "\n";
+            return 1;
+        }
+        symbols.write(sym_file);
+    }
+
+    std::cout << "Link successful. Kept " << objectLinker.sectionsKept() << " of "
+              << objectLinker.sectionsTotal() << " sections (" << image.size() << " words). "
+              << "Output written to " << output_path.string() << "\n";
+    return 0;
+}
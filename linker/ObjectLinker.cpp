@@ -0,0 +1,177 @@
+#include "ObjectLinker.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+
+namespace linker {
+
+namespace {
+
+constexpr size_t ROM_SIZE = 32768;
+
+struct Location {
+    size_t section; // index into the flattened section list
+    unsigned int offset;
+};
+
+bool endsInUnconditionalJump(const std::vector<uint16_t>& code) {
+    // C-instruction with all three jump bits set (;JMP)
+    return !code.empty() && (code.back() & 0xE007) == 0xE007;
+}
+
+} // namespace
+
+void ObjectLinker::addObject(assembler::ObjectFile obj, const std::string& name) {
+    for (const auto& symbol : obj.symbols) {
+        if (symbol.section >= obj.sections.size() || symbol.offset > obj.sections[symbol.section].code.size()) {
+            throw std::runtime_error("[Error] " + name + ": symbol " + symbol.name + " outside of its section");
+        }
+    }
+    for (const auto& reloc : obj.relocations) {
+        if (reloc.section >= obj.sections.size() || reloc.offset >= obj.sections[reloc.section].code.size()) {
+            throw std::runtime_error("[Error] " + name + ": relocation for " + reloc.name + " outside of its section");
+        }
+    }
+    inputs.push_back({name, std::move(obj)});
+}
+
+std::vector<uint16_t> ObjectLinker::link(bool drop_unreferenced, assembler::SymbolFile* symbols) {
+    // flatten sections of all objects, in input order
+    std::vector<const std::vector<uint16_t>*> sections;
+    std::vector<size_t> first_section; // per input
+    for (const auto& input : inputs) {
+        first_section.push_back(sections.size());
+        for (const auto& section : input.obj.sections) {
+            sections.push_back(&section.code);
+        }
+    }
+    sections_total = sections.size();
+
+    // symbol tables: per object, and every definition across objects
+    std::vector<std::unordered_map<std::string, Location>> local(inputs.size());
+    std::unordered_map<std::string, std::vector<Location>> global;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        for (const auto& symbol : inputs[i].obj.symbols) {
+            Location loc{first_section[i] + symbol.section, symbol.offset};
+            local[i].emplace(symbol.name, loc);
+            global[symbol.name].push_back(loc);
+        }
+    }
+
+    // resolve every relocation to a label location, or to a variable (nullptr)
+    struct Resolved {
+        unsigned int offset;
+        const std::string* name;
+        const Location* target;
+    };
+    std::vector<std::vector<Resolved>> relocations(sections.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        for (const auto& reloc : inputs[i].obj.relocations) {
+            const Location* target = nullptr;
+            auto it = local[i].find(reloc.name);
+            if (it != local[i].end()) {
+                target = &it->second;
+            } else if (auto git = global.find(reloc.name); git != global.end()) {
+                if (git->second.size() > 1) {
+                    throw std::runtime_error("[Error] " + inputs[i].name + ": reference to " + reloc.name +
+                                             " is ambiguous, it is defined by several objects");
+                }
+                target = &git->second.front();
+            }
+            relocations[first_section[i] + reloc.section].push_back({reloc.offset, &reloc.name, target});
+        }
+    }
+    for (auto& section_relocs : relocations) {
+        std::sort(section_relocs.begin(), section_relocs.end(),
+                  [](const Resolved& a, const Resolved& b) { return a.offset < b.offset; });
+    }
+
+    // mark reachable sections, starting from the entry point
+    std::vector<bool> keep(sections.size(), !drop_unreferenced);
+    if (drop_unreferenced && !sections.empty()) {
+        std::vector<size_t> worklist{0};
+        keep[0] = true;
+        while (!worklist.empty()) {
+            size_t s = worklist.back();
+            worklist.pop_back();
+            auto visit = [&](size_t next) {
+                if (!keep[next]) {
+                    keep[next] = true;
+                    worklist.push_back(next);
+                }
+            };
+            for (const auto& reloc : relocations[s]) {
+                if (reloc.target) visit(reloc.target->section);
+            }
+            if (!endsInUnconditionalJump(*sections[s]) && s + 1 < sections.size()) {
+                visit(s + 1);
+            }
+        }
+    }
+
+    // lay out the kept sections in input order
+    std::vector<size_t> base(sections.size(), 0);
+    size_t rom_size = 0;
+    sections_kept = 0;
+    for (size_t s = 0; s < sections.size(); ++s) {
+        if (!keep[s]) continue;
+        base[s] = rom_size;
+        rom_size += sections[s]->size();
+        ++sections_kept;
+    }
+    if (rom_size > ROM_SIZE) {
+        throw std::runtime_error("[Error] linked program of " + std::to_string(rom_size) +
+                                 " words does not fit in the 32K ROM");
+    }
+
+    // copy code, patching in label addresses and allocating variables
+    std::vector<uint16_t> image;
+    image.reserve(rom_size);
+    std::unordered_map<std::string, unsigned int> variables;
+    unsigned int ram_address = 16; // variables are allocated starting at RAM address 16
+    for (size_t s = 0; s < sections.size(); ++s) {
+        if (!keep[s]) continue;
+        image.insert(image.end(), sections[s]->begin(), sections[s]->end());
+        for (const auto& reloc : relocations[s]) {
+            size_t address;
+            if (reloc.target) {
+                address = base[reloc.target->section] + reloc.target->offset;
+            } else {
+                auto [it, inserted] = variables.emplace(*reloc.name, ram_address);
+                if (inserted) ++ram_address;
+                address = it->second;
+            }
+            if (address >= ROM_SIZE) {
+                // a label just past the last word, or more variables than RAM
+                throw std::runtime_error("[Error] address " + std::to_string(address) + " of " + *reloc.name +
+                                         " does not fit in an A-instruction");
+            }
+            image[base[s] + reloc.offset] = static_cast<uint16_t>(address);
+        }
+    }
+
+    if (symbols) {
+        symbols->labels.clear();
+        symbols->variables.clear();
+        symbols->lines.clear();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            for (const auto& symbol : inputs[i].obj.symbols) {
+                size_t s = first_section[i] + symbol.section;
+                if (!keep[s]) continue;
+                symbols->labels.push_back({static_cast<unsigned int>(base[s] + symbol.offset), symbol.name});
+            }
+        }
+        for (const auto& [name, address] : variables) {
+            symbols->variables.push_back({address, name});
+        }
+        auto by_address = [](const assembler::SymbolFile::Symbol& a, const assembler::SymbolFile::Symbol& b) {
+            return a.address < b.address;
+        };
+        std::stable_sort(symbols->labels.begin(), symbols->labels.end(), by_address);
+        std::sort(symbols->variables.begin(), symbols->variables.end(), by_address);
+    }
+    return image;
+}
+
+} // namespace linker
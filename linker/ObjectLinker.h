@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../assembler/ObjectFile.h"
+#include "../assembler/SymbolFile.h"
+
+namespace linker {
+
+// combines relocatable objects into one Hack machine code image.
+//
+// A reference resolves to the label of the same name in its own object if
+// there is one, otherwise to the single object that defines it; a name no
+// object defines is a variable and gets the next RAM address from 16 upward,
+// in order of first use in the linked image (as the two-pass assembler would).
+// Execution starts at the first section of the first object.
+class ObjectLinker {
+    struct Input {
+        std::string name;
+        assembler::ObjectFile obj;
+    };
+    std::vector<Input> inputs;
+    size_t sections_total = 0;
+    size_t sections_kept = 0;
+
+public:
+    void addObject(assembler::ObjectFile obj, const std::string& name);
+
+    // drop_unreferenced: leave out sections that cannot be reached from the
+    // entry point by a label reference or by falling through. symbols, if
+    // given, receives the labels of the kept sections and the variables;
+    // objects carry no source lines, so its line map stays empty. Throws,
+    // before patching any code, when the kept sections add up to more than
+    // the 32K ROM
+    std::vector<uint16_t> link(bool drop_unreferenced = true, assembler::SymbolFile* symbols = nullptr);
+
+    size_t sectionsTotal() const { return sections_total; }
+    size_t sectionsKept() const { return sections_kept; }
+};
+
+} // namespace linker
@@ -0,0 +1,77 @@
+#!/usr/bin/env bash
+# linker checks: --keep-all reproduces the assembler, dropping unreferenced
+# sections keeps the program's behaviour, and hackc --incremental rebuilds
+# only the objects whose source or toolchain changed; a program larger than
+# the ROM is rejected
+set -euo pipefail
+source "$REPO/tools/test_lib.sh"
+cd "$REPO"
+
+# screen <dump.hack>: the screen map part of a RAM dump
+screen() {
+    sed -n '16385,24576p' "$1"
+}
+
+mkdir -p "$WORK/seven"
+hackc compiler/test_programs/Seven -o "$WORK/seven/o.hack" --keep-temps
+cd "$WORK/seven/src"
+"$BIN/Assembler" src.asm > /dev/null
+"$BIN/Assembler" -c src.asm > /dev/null
+"$BIN/Linker" --keep-all -o keep-all.hack src.hobj > /dev/null
+same "--keep-all matches the assembler" src.hack keep-all.hack
+
+"$BIN/Linker" -o linked.hack src.hobj > /dev/null
+(( $(wc -l < linked.hack) < $(wc -l < src.hack) )) || fail "no unreferenced sections dropped"
+ok "unreferenced sections dropped ($(wc -l < src.hack) -> $(wc -l < linked.hack) words)"
+run src.hack 20000000 src.ram.hack
+run linked.hack 20000000 linked.ram.hack
+cmp -s <(screen src.ram.hack) <(screen linked.ram.hack) || fail "linked program draws a different screen"
+ok "linked program draws the same screen"
+cd "$REPO"
+
+# rebuilt <out.hack> [hackc]: builds $WORK/inc incrementally and prints how
+# many objects were rebuilt
+rebuilt() {
+    "${2:-$BIN/hackc}" "$WORK/inc" -o "$1" --incremental > "$WORK/hackc.log" ||
+        { cat "$WORK/hackc.log" >&2; fail "hackc --incremental"; }
+    sed -n 's/.*rebuilt \([0-9]*\) of.*/\1/p' "$WORK/hackc.log"
+}
+
+mkdir -p "$WORK/inc"
+cp compiler/test_programs/Seven/*.jack "$WORK/inc/"
+all="$(rebuilt "$WORK/inc/out/o.hack")"
+(( all > 1 )) || fail "first incremental build rebuilt $all objects"
+run "$WORK/inc/out/o.hack" 20000000 "$WORK/inc.ram.hack"
+cmp -s <(screen "$WORK/seven/src/src.ram.hack") <(screen "$WORK/inc.ram.hack") ||
+    fail "incremental build draws a different screen"
+ok "incremental build draws the same screen"
+
+[[ "$(rebuilt "$WORK/inc/out/o.hack")" == 0 ]] || fail "unchanged sources were rebuilt"
+ok "unchanged sources reuse every object"
+
+echo "// changed" >> "$WORK/inc/Main.jack"
+[[ "$(rebuilt "$WORK/inc/out/o.hack")" == 1 ]] || fail "changing Main.jack did not rebuild exactly one object"
+ok "changing one class rebuilds one object"
+
+# a different driver executable (here the same one with a byte appended)
+# invalidates every object
+cp "$BIN/hackc" "$WORK/hackc-changed"
+printf '\0' >> "$WORK/hackc-changed"
+[[ "$(rebuilt "$WORK/inc/out/o.hack" "$WORK/hackc-changed")" == "$all" ]] ||
+    fail "a changed toolchain did not rebuild every object"
+ok "a changed toolchain rebuilds every object"
+
+# a program filling the ROM links; one word more is an error that writes nothing
+mkdir -p "$WORK/big"
+cd "$WORK/big"
+big() {
+    { echo "(start)"; for ((i = 0; i < $1 - 2; ++i)); do echo "D=D+1"; done; echo "@start"; echo "0;JMP"; } > big.asm
+    "$BIN/Assembler" -c big.asm > /dev/null
+    rm -f big.hack
+    "$BIN/Linker" -o big.hack big.hobj > big.log 2>&1
+}
+big 32768 || { cat big.log >&2; fail "a 32768-word program does not link"; }
+big 32769 && fail "a 32769-word program links"
+grep -q '32769 words does not fit' big.log || { cat big.log >&2; fail "no size error for 32769 words"; }
+[[ ! -e big.hack ]] || fail "an oversize program was written"
+ok "32768 words link, 32769 words are rejected without output"
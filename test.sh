@@ -0,0 +1,73 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Builds every tool into build/test/bin and runs the regression suites in
+# <dir>/test/run.sh. Pass suite directories (e.g. ./test.sh assembler) to
+# run only those; the tools are rebuilt either way.
+
+REPO="$(cd "$(dirname "$0")" && pwd)"
+OUT="$REPO/build/test"
+BIN="$OUT/bin"
+CXX="${CXX:-g++}"
+CXXFLAGS=(-std=c++17 -O2)
+
+SUITES=(compiler VM assembler linker driver emulator OS/myOS hack_computer)
+if (( $# )); then
+    SUITES=("$@")
+fi
+
+rm -rf "$OUT"
+mkdir -p "$BIN"
+
+build() {
+    local name="$1"
+    shift
+    echo "building $name"
+    "$CXX" "${CXXFLAGS[@]}" -o "$BIN/$name" "$@"
+}
+
+cd "$REPO/compiler"
+build j JackCompiler.cpp JackTokenizer.cpp CompilationEngine.cpp VMWriter.cpp SymbolTable.cpp TokenUtils.cpp
+cd "$REPO/VM"
+build VirtualMachine VirtualMachine.cpp Parser.cpp CodeWriter.cpp NativeBodies.cpp
+build VMInterpreter VMInterpreter.cpp Interpreter.cpp Parser.cpp ../assembler/RomImage.cpp
+cd "$REPO/assembler"
+build Assembler Assembler.cpp Parser.cpp Coder.cpp SymbolTable.cpp HackAssembler.cpp ObjectFile.cpp \
+    RomImage.cpp Optimizer.cpp SymbolFile.cpp
+cd "$REPO/linker"
+build Linker Linker.cpp ObjectLinker.cpp \
+    ../assembler/HackAssembler.cpp ../assembler/ObjectFile.cpp ../assembler/RomImage.cpp \
+    ../assembler/Optimizer.cpp ../assembler/SymbolFile.cpp \
+    ../assembler/Parser.cpp ../assembler/Coder.cpp ../assembler/SymbolTable.cpp
+cd "$REPO/driver"
+build hackc Driver.cpp \
+    ../compiler/JackTokenizer.cpp ../compiler/CompilationEngine.cpp ../compiler/VMWriter.cpp \
+    ../compiler/SymbolTable.cpp ../compiler/TokenUtils.cpp \
+    ../VM/Parser.cpp ../VM/CodeWriter.cpp ../VM/NativeBodies.cpp \
+    ../assembler/Parser.cpp ../assembler/Coder.cpp ../assembler/SymbolTable.cpp ../assembler/HackAssembler.cpp \
+    ../assembler/ObjectFile.cpp ../assembler/RomImage.cpp ../assembler/Optimizer.cpp \
+    ../assembler/SymbolFile.cpp ../linker/ObjectLinker.cpp
+cd "$REPO/emulator"
+build Emulator Emulator.cpp Cpu.cpp Jit.cpp KeyScript.cpp Screen.cpp Profiler.cpp \
+    Lockstep.cpp ../assembler/RomImage.cpp ../assembler/SymbolFile.cpp
+CXXFLAGS+=(-pthread)
+build BatchRunner BatchRunner.cpp Cpu.cpp KeyScript.cpp ThreadPool.cpp ../assembler/RomImage.cpp
+cd "$REPO"
+
+failed=()
+for suite in "${SUITES[@]}"; do
+    suite="${suite%/}"
+    [[ -f "$REPO/$suite/test/run.sh" ]] || continue
+    echo "suite $suite"
+    work="$OUT/work/$suite"
+    mkdir -p "$work"
+    if ! REPO="$REPO" BIN="$BIN" WORK="$work" bash "$REPO/$suite/test/run.sh"; then
+        failed+=("$suite")
+    fi
+done
+
+if (( ${#failed[@]} )); then
+    echo "failed: ${failed[*]}" >&2
+    exit 1
+fi
+echo "all suites passed"
@@ -0,0 +1,47 @@
+# helpers for the <dir>/test/run.sh suites, sourced by each of them.
+# test.sh runs the suites with REPO (the repository), BIN (the tools it just
+# built) and WORK (an empty scratch directory for the suite) set.
+
+: "${REPO:?run the suites through test.sh}"
+: "${BIN:?run the suites through test.sh}"
+: "${WORK:?run the suites through test.sh}"
+
+ok() {
+    echo "  ok    $*"
+}
+
+fail() {
+    echo "  FAIL  $*" >&2
+    exit 1
+}
+
+# same <what> <file> <file>: the files are byte-identical
+same() {
+    cmp -s "$2" "$3" || fail "$1: $2 and $3 differ"
+    ok "$1"
+}
+
+# ram <dump.hack> <address> [count]: count (default 1) RAM words from a
+# --dump in .hack format, as signed decimals, one per line
+ram() {
+    awk -v first="$(($2 + 1))" -v last="$(($2 + ${3:-1}))" '
+        NR >= first && NR <= last {
+            v = 0
+            for (i = 1; i <= 16; i++) v = v * 2 + substr($0, i, 1)
+            print (v >= 32768) ? v - 65536 : v
+        }' "$1"
+}
+
+# hackc <args>: hackc with its build report dropped
+hackc() {
+    "$BIN/hackc" "$@" > "$WORK/hackc.log" || { cat "$WORK/hackc.log" >&2; fail "hackc $*"; }
+}
+
+# run <image> <cycles> <dump> [emulator args]: runs image until it halts or
+# cycles instructions have run and dumps its RAM
+run() {
+    local image="$1" cycles="$2" dump="$3"
+    shift 3
+    "$BIN/Emulator" "$image" --max-cycles "$cycles" --dump "$dump" "$@" > "$WORK/emulator.log" 2>&1 ||
+        { cat "$WORK/emulator.log" >&2; fail "Emulator $image"; }
+}